@@ -0,0 +1,291 @@
+//
+// Created by Camiel Verdult on 17/10/2026.
+//
+
+// Compares the mc containers against their libstdc++ counterparts.
+// Run with --benchmark_format=json (or --benchmark_out=<file> --benchmark_out_format=json)
+// to get machine-readable results that can be compared between versions.
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "concurrent_map.h"
+#include "map.h"
+#include "vector.h"
+
+namespace {
+
+    template <typename T>
+    T make_value(std::size_t i) {
+        if constexpr (std::is_same_v<T, std::string>) {
+            // Long enough to not fit the small string optimisation, so copies really cost something
+            return "benchmark value that is on the heap " + std::to_string(i);
+        } else {
+            return static_cast<T>(i);
+        }
+    }
+
+    // Shuffled values, so sorting and lookups do not get an easy pattern
+    template <typename T>
+    std::vector<T> make_values(std::size_t count) {
+        std::vector<T> values;
+        values.reserve(count);
+
+        for (std::size_t i = 0; i < count; i++) {
+            values.push_back(make_value<T>(i));
+        }
+
+        std::shuffle(values.begin(), values.end(), std::mt19937{42});
+        return values;
+    }
+
+    template <typename Vector>
+    Vector make_vector(const std::vector<typename Vector::value_type>& values) {
+        Vector vec{};
+
+        for (const auto& value : values) {
+            vec.push_back(value);
+        }
+
+        return vec;
+    }
+
+    template <typename Vector>
+    void sort_vector(Vector& vec) {
+        if constexpr (requires { vec.sort(); }) {
+            vec.sort();
+        } else {
+            std::sort(vec.begin(), vec.end());
+        }
+    }
+
+    template <typename Vector>
+    void push_back(benchmark::State& state) {
+        using T = typename Vector::value_type;
+        auto values = make_values<T>(static_cast<std::size_t>(state.range(0)));
+
+        for (auto _ : state) {
+            Vector vec{};
+
+            for (const auto& value : values) {
+                vec.push_back(value);
+            }
+
+            benchmark::DoNotOptimize(vec.begin());
+        }
+
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    template <typename Vector>
+    void insert_front(benchmark::State& state) {
+        using T = typename Vector::value_type;
+        auto values = make_values<T>(static_cast<std::size_t>(state.range(0)));
+
+        for (auto _ : state) {
+            Vector vec{};
+
+            for (const auto& value : values) {
+                if constexpr (requires { vec.insert(vec.begin(), value); }) {
+                    vec.insert(vec.begin(), value);
+                } else {
+                    vec.insert(0, value);
+                }
+            }
+
+            benchmark::DoNotOptimize(vec.begin());
+        }
+
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    template <typename Vector>
+    void erase_front(benchmark::State& state) {
+        using T = typename Vector::value_type;
+        auto values = make_values<T>(static_cast<std::size_t>(state.range(0)));
+
+        for (auto _ : state) {
+            state.PauseTiming();
+            auto vec = make_vector<Vector>(values);
+            state.ResumeTiming();
+
+            while (vec.size() != 0) {
+                if constexpr (requires { vec.erase(vec.begin()); }) {
+                    vec.erase(vec.begin());
+                } else {
+                    vec.erase(0);
+                }
+            }
+
+            benchmark::DoNotOptimize(vec.begin());
+        }
+
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    template <typename Vector>
+    void copy(benchmark::State& state) {
+        using T = typename Vector::value_type;
+        auto vec = make_vector<Vector>(make_values<T>(static_cast<std::size_t>(state.range(0))));
+
+        for (auto _ : state) {
+            Vector copied{vec};
+            benchmark::DoNotOptimize(copied.begin());
+        }
+
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    template <typename Vector>
+    void sort(benchmark::State& state) {
+        using T = typename Vector::value_type;
+        auto vec = make_vector<Vector>(make_values<T>(static_cast<std::size_t>(state.range(0))));
+
+        for (auto _ : state) {
+            state.PauseTiming();
+            Vector shuffled{vec};
+            state.ResumeTiming();
+
+            sort_vector(shuffled);
+            benchmark::DoNotOptimize(shuffled.begin());
+        }
+
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    template <typename Vector>
+    void equality(benchmark::State& state) {
+        using T = typename Vector::value_type;
+        auto a = make_vector<Vector>(make_values<T>(static_cast<std::size_t>(state.range(0))));
+        Vector b{a};
+
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(a == b);
+        }
+
+        state.SetBytesProcessed(state.iterations() * state.range(0) * static_cast<int64_t>(sizeof(T)) * 2);
+    }
+
+    template <typename Map>
+    void map_lookup(benchmark::State& state) {
+        using key_type = typename Map::key_type;
+        auto keys = make_values<key_type>(static_cast<std::size_t>(state.range(0)));
+
+        Map lookup;
+        for (const auto& key : keys) {
+            if constexpr (requires { lookup.insert_or_assign(key, 0); }) {
+                lookup.insert_or_assign(key, 0);
+            }
+        }
+
+        std::size_t i = 0;
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(lookup.find(keys[i]));
+            i = i + 1 == keys.size() ? 0 : i + 1;
+        }
+
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    // mc::map has no key_type, give it one so map_lookup can treat all maps the same
+    template <typename TKey, typename TValue>
+    struct mc_map : mc::map<TKey, TValue> {
+        using key_type = TKey;
+    };
+
+    // What concurrent_map is compared against: one std::unordered_map behind one reader/writer lock
+    template <typename TKey, typename TValue>
+    class locked_map {
+    public:
+        void insert_or_assign(const TKey& key, TValue value) {
+            std::unique_lock lock{m_lock};
+            m_map.insert_or_assign(key, std::move(value));
+        }
+
+        std::optional<TValue> find(const TKey& key) const {
+            std::shared_lock lock{m_lock};
+            auto found = m_map.find(key);
+
+            if (found == m_map.end()) {
+                return std::nullopt;
+            }
+
+            return found->second;
+        }
+
+    private:
+        mutable std::shared_mutex m_lock;
+        std::unordered_map<TKey, TValue> m_map;
+    };
+
+    constexpr std::size_t CONCURRENT_KEYS{1 << 16};
+
+    // Every thread looks up keys in the same map, the items per second should grow with the threads
+    template <typename Map>
+    void concurrent_lookup(benchmark::State& state) {
+        // Shared by all threads and all runs, the first thread that gets here fills it
+        static const std::vector<uint64_t> keys = make_values<uint64_t>(CONCURRENT_KEYS);
+        static Map lookup;
+        static std::once_flag filled;
+
+        std::call_once(filled, [] {
+            for (uint64_t key : keys) {
+                lookup.insert_or_assign(key, 0);
+            }
+        });
+
+        // Every thread starts somewhere else in the keys
+        std::size_t i = static_cast<std::size_t>(state.thread_index()) * CONCURRENT_KEYS / static_cast<std::size_t>(state.threads());
+
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(lookup.find(keys[i]));
+            i = i + 1 == keys.size() ? 0 : i + 1;
+        }
+
+        state.SetItemsProcessed(state.iterations());
+    }
+}
+
+// Sizes from a couple of cache lines up to way past L2
+#define MC_SIZES RangeMultiplier(8)->Range(64, 1 << 18)
+#define MC_SMALL_SIZES RangeMultiplier(8)->Range(64, 1 << 12) // insert and erase at the front are O(n^2)
+
+#define MC_VECTOR_BENCHMARKS(T) \
+    BENCHMARK_TEMPLATE(push_back, mc::vector<T>)->MC_SIZES; \
+    BENCHMARK_TEMPLATE(push_back, std::vector<T>)->MC_SIZES; \
+    BENCHMARK_TEMPLATE(insert_front, mc::vector<T>)->MC_SMALL_SIZES; \
+    BENCHMARK_TEMPLATE(insert_front, std::vector<T>)->MC_SMALL_SIZES; \
+    BENCHMARK_TEMPLATE(erase_front, mc::vector<T>)->MC_SMALL_SIZES; \
+    BENCHMARK_TEMPLATE(erase_front, std::vector<T>)->MC_SMALL_SIZES; \
+    BENCHMARK_TEMPLATE(copy, mc::vector<T>)->MC_SIZES; \
+    BENCHMARK_TEMPLATE(copy, std::vector<T>)->MC_SIZES; \
+    BENCHMARK_TEMPLATE(sort, mc::vector<T>)->MC_SIZES; \
+    BENCHMARK_TEMPLATE(sort, std::vector<T>)->MC_SIZES; \
+    BENCHMARK_TEMPLATE(equality, mc::vector<T>)->MC_SIZES; \
+    BENCHMARK_TEMPLATE(equality, std::vector<T>)->MC_SIZES
+
+MC_VECTOR_BENCHMARKS(int);
+MC_VECTOR_BENCHMARKS(uint64_t);
+MC_VECTOR_BENCHMARKS(std::string);
+
+#define MC_MAP_BENCHMARKS(K) \
+    BENCHMARK_TEMPLATE(map_lookup, mc_map<K, int>)->MC_SIZES; \
+    BENCHMARK_TEMPLATE(map_lookup, std::map<K, int>)->MC_SIZES; \
+    BENCHMARK_TEMPLATE(map_lookup, std::unordered_map<K, int>)->MC_SIZES
+
+MC_MAP_BENCHMARKS(uint64_t);
+MC_MAP_BENCHMARKS(std::string);
+
+BENCHMARK_TEMPLATE(concurrent_lookup, mc::concurrent_map<uint64_t, int>)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(concurrent_lookup, locked_map<uint64_t, int>)->ThreadRange(1, 8)->UseRealTime();
+
+BENCHMARK_MAIN();
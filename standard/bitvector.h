@@ -0,0 +1,332 @@
+//
+// Created by Camiel Verdult on 17/10/2026.
+//
+
+#ifndef APC_LIBRARY_BITVECTOR_H
+#define APC_LIBRARY_BITVECTOR_H
+
+#include "simd.h"
+#include "vector.h"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iostream>
+#include <span>
+
+namespace mc {
+
+    // A vector of bools that stores one bit per bool in 64 bit words, 8 times smaller than mc::vector<bool>.
+    // Whole-vector operations work a word at a time: count() uses popcount and the bulk &=, |=, ^= and flip()
+    // use SIMD where the CPU has it (see simd.h). find_first()/find_next() skip 64 zero bits per step.
+    //
+    // This is a separate class instead of a specialisation of mc::vector<bool>, so mc::vector<T> stays
+    // a contiguous range of real T for every T. Bits past size() in the last word are always 0
+    class bitvector {
+    public:
+        using word_type = std::uint64_t;
+
+        static constexpr std::size_t WORD_BITS{64};
+
+        // Returned by find_first and find_next when there is no set bit
+        static constexpr std::size_t npos{static_cast<std::size_t>(-1)};
+
+        // Stands in for a bool& to a single bit
+        class reference {
+        public:
+            reference(word_type& word, word_type mask) noexcept : m_word{&word}, m_mask{mask} {}
+
+            reference(const reference&) = default;
+
+            operator bool() const noexcept {
+                return (*m_word & m_mask) != 0;
+            }
+
+            reference& operator=(bool value) noexcept {
+                if (value) {
+                    *m_word |= m_mask;
+                } else {
+                    *m_word &= ~m_mask;
+                }
+
+                return *this;
+            }
+
+            // Assigns the value of the other bit, not the reference itself
+            reference& operator=(const reference& other) noexcept {
+                return *this = static_cast<bool>(other);
+            }
+
+            bool operator~() const noexcept {
+                return not static_cast<bool>(*this);
+            }
+
+            reference& flip() noexcept {
+                *m_word ^= m_mask;
+                return *this;
+            }
+
+        private:
+            word_type* m_word;
+            word_type m_mask;
+        };
+
+        // Default constructor, this does not allocate anything
+        bitvector() : m_words(0) {}
+
+        // count bits that are all value
+        explicit bitvector(std::size_t count, bool value = false) : m_words(words_for(count)) {
+            m_words.resize(words_for(count), value ? ~word_type{0} : 0);
+            m_bits = count;
+            clear_tail();
+        }
+
+        // initializer list constructor
+        bitvector(std::initializer_list<bool> list) : bitvector() {
+            reserve(list.size());
+
+            for (bool value : list) {
+                push_back(value);
+            }
+        }
+
+        [[maybe_unused]] [[nodiscard]] std::size_t size() const noexcept {
+            return m_bits;
+        }
+
+        // The number of bits that fit without allocating
+        [[maybe_unused]] [[nodiscard]] std::size_t capacity() const noexcept {
+            return m_words.capacity() * WORD_BITS;
+        }
+
+        // The words holding the bits, bit i is bit i % 64 of word i / 64
+        [[maybe_unused]] std::span<const word_type> words() const noexcept {
+            return {m_words.begin(), m_words.size()};
+        }
+
+        [[maybe_unused]] void reserve(std::size_t bits) {
+            m_words.reserve(words_for(bits));
+        }
+
+        [[maybe_unused]] void push_back(bool value) {
+            if (m_bits % WORD_BITS == 0) {
+                m_words.push_back(0);
+            }
+
+            m_bits++;
+            (*this)[m_bits - 1] = value;
+        }
+
+        [[maybe_unused]] void pop_back() {
+            (*this)[m_bits - 1] = false;
+            m_bits--;
+
+            if (m_bits % WORD_BITS == 0) {
+                m_words.pop_back();
+            }
+        }
+
+        // Grows or shrinks to count bits, new bits get value
+        [[maybe_unused]] void resize(std::size_t count, bool value = false) {
+            if (count < m_bits) {
+                m_words.resize(words_for(count));
+                m_bits = count;
+                clear_tail();
+                return;
+            }
+
+            // Fill the rest of the current last word first, then whole words at once
+            while (m_bits < count and m_bits % WORD_BITS != 0) {
+                push_back(value);
+            }
+
+            m_words.resize(words_for(count), value ? ~word_type{0} : 0);
+            m_bits = count;
+            clear_tail();
+        }
+
+        // Removes all bits
+        [[maybe_unused]] void erase() {
+            m_words.erase();
+            m_bits = 0;
+        }
+
+        [[maybe_unused]] reference operator[](std::size_t index) noexcept {
+            return {m_words[index / WORD_BITS], mask_of(index)};
+        }
+
+        [[maybe_unused]] bool operator[](std::size_t index) const noexcept {
+            return (m_words[index / WORD_BITS] & mask_of(index)) != 0;
+        }
+
+        [[maybe_unused]] reference at(std::size_t index) {
+            if (index >= m_bits) {
+                // Index is out of bounds
+                throw "bitvector_error: at(i) is out of bounds\n";
+            }
+
+            return (*this)[index];
+        }
+
+        [[maybe_unused]] [[nodiscard]] bool at(std::size_t index) const {
+            if (index >= m_bits) {
+                // Index is out of bounds
+                throw "bitvector_error: at(i) is out of bounds\n";
+            }
+
+            return (*this)[index];
+        }
+
+        // Sets every bit to 1
+        [[maybe_unused]] void set() {
+            std::fill(m_words.begin(), m_words.end(), ~word_type{0});
+            clear_tail();
+        }
+
+        // Sets every bit to 0
+        [[maybe_unused]] void reset() {
+            std::fill(m_words.begin(), m_words.end(), 0);
+        }
+
+        // Inverts every bit
+        [[maybe_unused]] void flip() {
+            simd::bitwise<simd::bit_op::bit_not>(m_words.begin(), m_words.begin(), m_words.size());
+            clear_tail();
+        }
+
+        // The number of set bits
+        [[maybe_unused]] [[nodiscard]] std::size_t count() const {
+            return simd::popcount(m_words.begin(), m_words.size());
+        }
+
+        [[maybe_unused]] [[nodiscard]] bool any() const {
+            return find_first() != npos;
+        }
+
+        [[maybe_unused]] [[nodiscard]] bool none() const {
+            return not any();
+        }
+
+        [[maybe_unused]] [[nodiscard]] bool all() const {
+            return count() == m_bits;
+        }
+
+        // Returns the index of the first set bit, or npos if no bit is set
+        [[maybe_unused]] [[nodiscard]] std::size_t find_first() const noexcept {
+            return find_from(0);
+        }
+
+        // Returns the index of the first set bit after index, or npos if there is none
+        [[maybe_unused]] [[nodiscard]] std::size_t find_next(std::size_t index) const noexcept {
+            return index + 1 >= m_bits ? npos : find_from(index + 1);
+        }
+
+        // The sizes have to match for the bulk operations
+        [[maybe_unused]] bitvector& operator&=(const bitvector& other) {
+            return combine<simd::bit_op::bit_and>(other);
+        }
+
+        [[maybe_unused]] bitvector& operator|=(const bitvector& other) {
+            return combine<simd::bit_op::bit_or>(other);
+        }
+
+        [[maybe_unused]] bitvector& operator^=(const bitvector& other) {
+            return combine<simd::bit_op::bit_xor>(other);
+        }
+
+        // Returns a flipped copy
+        [[maybe_unused]] bitvector operator~() const {
+            bitvector flipped{*this};
+            flipped.flip();
+            return flipped;
+        }
+
+        friend bool operator==(const bitvector& a, const bitvector& b) {
+            // The tails are always 0, so equal bits means equal words
+            return a.m_bits == b.m_bits and simd::equal(a.m_words.begin(), b.m_words.begin(), a.m_words.size());
+        }
+
+    private:
+        static constexpr std::size_t words_for(std::size_t bits) noexcept {
+            return (bits + WORD_BITS - 1) / WORD_BITS;
+        }
+
+        static constexpr word_type mask_of(std::size_t index) noexcept {
+            return word_type{1} << (index % WORD_BITS);
+        }
+
+        // Keeps the bits past size() in the last word at 0, so count, == and find never see them
+        void clear_tail() noexcept {
+            if (m_bits % WORD_BITS != 0) {
+                m_words[m_words.size() - 1] &= (word_type{1} << (m_bits % WORD_BITS)) - 1;
+            }
+        }
+
+        [[nodiscard]] std::size_t find_from(std::size_t index) const noexcept {
+            std::size_t word = index / WORD_BITS;
+
+            if (word >= m_words.size()) {
+                return npos;
+            }
+
+            // Ignore the bits before index in the first word
+            word_type bits = m_words[word] & (~word_type{0} << (index % WORD_BITS));
+
+            while (bits == 0) {
+                if (++word == m_words.size()) {
+                    return npos;
+                }
+
+                bits = m_words[word];
+            }
+
+            return word * WORD_BITS + static_cast<std::size_t>(std::countr_zero(bits));
+        }
+
+        template <simd::bit_op Op>
+        bitvector& combine(const bitvector& other) {
+            if (other.m_bits != m_bits) {
+                throw "bitvector_error: the bitvectors have different sizes\n";
+            }
+
+            simd::bitwise<Op>(m_words.begin(), other.m_words.begin(), m_words.size());
+            return *this;
+        }
+
+        mc::vector<word_type> m_words;
+        std::size_t m_bits{0};
+    };
+
+    // a is returned on its own line, returning the reference from a &= b would copy all words instead of moving them
+    [[maybe_unused]] inline bitvector operator&(bitvector a, const bitvector& b) {
+        a &= b;
+        return a;
+    }
+
+    [[maybe_unused]] inline bitvector operator|(bitvector a, const bitvector& b) {
+        a |= b;
+        return a;
+    }
+
+    [[maybe_unused]] inline bitvector operator^(bitvector a, const bitvector& b) {
+        a ^= b;
+        return a;
+    }
+
+    // Out stream operator for bitvector, prints the bits as 0s and 1s starting at index 0
+    inline std::ostream& operator<<(std::ostream& stream, const bitvector& other) {
+        stream << "mc::bitvector{";
+
+        for (std::size_t i = 0; i < other.size(); i++) {
+            stream << (other[i] ? '1' : '0');
+        }
+
+        stream << "}";
+
+        return stream;
+    }
+
+}
+
+#endif //APC_LIBRARY_BITVECTOR_H
@@ -0,0 +1,840 @@
+//
+// Created by Camiel Verdult on 17/10/2026.
+//
+
+#ifndef APC_LIBRARY_BTREE_MAP_H
+#define APC_LIBRARY_BTREE_MAP_H
+
+#include "instrumentation.h"
+#include "pair.h"
+#include "vector.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace mc {
+
+    // An ordered map for many keys that keep changing. mc::map::sort() keeps a flat array in order, which makes every
+    // insert in the middle O(n). This is a B+ tree: the pairs live in leaves of a few cache lines each and the inner
+    // nodes only hold keys to find the right leaf, so find/insert/erase are O(log n) with a wide fan-out and only a
+    // handful of cache misses per lookup. The leaves are linked, so iterating in key order just walks from leaf to leaf.
+    //
+    // Every node holds arrays of keys and values, so both have to be default constructible.
+    // Iterators point into a leaf and are invalidated by any insert or erase
+    template<typename TKey, typename TValue>
+    class btree_map {
+        static_assert(std::is_default_constructible_v<TKey> and std::is_default_constructible_v<TValue>,
+                      "btree_map nodes hold arrays of keys and values");
+
+    public:
+
+        using first_type = TKey;
+        using first_const_reference = const TKey&;
+
+        using second_type = TValue;
+
+        using pair_template = mc::pair<TKey, TValue>;
+        using value_type = pair_template;
+
+        using vector_template = mc::vector<pair_template>;
+
+        // A node is about NODE_BYTES big, but always has room for at least 8 entries
+        static constexpr std::size_t NODE_BYTES{256};
+        static constexpr std::size_t LEAF_SLOTS{std::max<std::size_t>(8, NODE_BYTES / sizeof(pair_template))};
+        static constexpr std::size_t INNER_SLOTS{std::max<std::size_t>(8, NODE_BYTES / (sizeof(TKey) + sizeof(void*)))};
+
+    private:
+        // Nodes that drop below half full borrow from or merge with a neighbour
+        static constexpr std::size_t LEAF_MIN{LEAF_SLOTS / 2};
+        static constexpr std::size_t INNER_MIN{INNER_SLOTS / 2};
+
+        // The tree can not get deeper than this, every inner node has at least 2 children
+        static constexpr std::size_t MAX_DEPTH{64};
+
+        struct node {
+            explicit node(bool is_leaf) : leaf{is_leaf} {}
+
+            // Every node goes through these, so new and delete anywhere in the tree are counted
+            static void* operator new(std::size_t bytes) {
+                void* memory = ::operator new(bytes);
+                instrumentation::record<btree_map>(instrumentation::event_kind::allocate, bytes, 0, 0);
+                return memory;
+            }
+
+            static void operator delete(void* memory, std::size_t bytes) noexcept {
+                instrumentation::record<btree_map>(instrumentation::event_kind::deallocate, bytes, 0, 0);
+                ::operator delete(memory, bytes);
+            }
+
+            bool leaf;
+            std::uint16_t count{0};
+        };
+
+        struct leaf_node : node {
+            leaf_node() : node(true) {}
+
+            leaf_node* next{nullptr};
+            pair_template slots[LEAF_SLOTS];
+        };
+
+        // children[i] holds the keys below keys[i], children[i + 1] the keys from keys[i] onwards
+        struct inner_node : node {
+            inner_node() : node(false) {}
+
+            TKey keys[INNER_SLOTS];
+            node* children[INNER_SLOTS + 1]{};
+        };
+
+        // The inner nodes on the way down to a leaf and which child was taken
+        struct path_entry {
+            inner_node* parent;
+            std::size_t index;
+        };
+
+    public:
+
+        // Walks the pairs in key order
+        template<bool Const>
+        class basic_iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = pair_template;
+            using difference_type = std::ptrdiff_t;
+            using pointer = std::conditional_t<Const, const pair_template*, pair_template*>;
+            using reference = std::conditional_t<Const, const pair_template&, pair_template&>;
+
+            using leaf_pointer = std::conditional_t<Const, const leaf_node*, leaf_node*>;
+
+            basic_iterator() = default;
+            basic_iterator(leaf_pointer leaf, std::size_t index) : m_leaf{leaf}, m_index{index} {}
+
+            // An iterator converts to a const_iterator
+            template<bool OtherConst> requires (Const and not OtherConst)
+            basic_iterator(const basic_iterator<OtherConst>& other) : m_leaf{other.m_leaf}, m_index{other.m_index} {}
+
+            reference operator*() const {
+                return m_leaf->slots[m_index];
+            }
+
+            pointer operator->() const {
+                return &m_leaf->slots[m_index];
+            }
+
+            basic_iterator& operator++() {
+                if (++m_index == m_leaf->count) {
+                    m_leaf = m_leaf->next;
+                    m_index = 0;
+                }
+
+                return *this;
+            }
+
+            basic_iterator operator++(int) {
+                basic_iterator previous = *this;
+                ++(*this);
+                return previous;
+            }
+
+            bool operator==(const basic_iterator& other) const {
+                return m_leaf == other.m_leaf and m_index == other.m_index;
+            }
+
+        private:
+            template<bool> friend class basic_iterator;
+
+            // end() is the null leaf
+            leaf_pointer m_leaf{nullptr};
+            std::size_t m_index{0};
+        };
+
+        using iterator = basic_iterator<false>;
+        using const_iterator = basic_iterator<true>;
+
+        btree_map() = default;
+
+        btree_map(std::initializer_list<pair_template> list) {
+            for (auto& entry : list) {
+                insert_or_assign(entry.first, entry.second);
+            }
+        }
+
+        // The pairs of other are already in order, so the copy is bulk loaded instead of inserted one by one
+        btree_map(const btree_map& other) {
+            instrumentation::record<btree_map>(instrumentation::event_kind::copy, other.m_size * sizeof(pair_template), 0, other.m_size);
+            vector_template sorted(other.m_size);
+
+            for (const auto& entry : other) {
+                sorted.push_back(entry);
+            }
+
+            build(std::move(sorted));
+        }
+
+        btree_map(btree_map&& other) noexcept :
+            m_root {std::exchange(other.m_root, nullptr)},
+            m_first {std::exchange(other.m_first, nullptr)},
+            m_size {std::exchange(other.m_size, 0)} {}
+
+        ~btree_map() {
+            erase();
+        }
+
+        btree_map& operator=(const btree_map& other) {
+            if (this != &other) {
+                btree_map copy{other};
+                *this = std::move(copy);
+            }
+
+            return *this;
+        }
+
+        btree_map& operator=(btree_map&& other) noexcept {
+            if (this != &other) {
+                erase();
+
+                m_root = std::exchange(other.m_root, nullptr);
+                m_first = std::exchange(other.m_first, nullptr);
+                m_size = std::exchange(other.m_size, 0);
+            }
+
+            return *this;
+        }
+
+        [[maybe_unused]] [[nodiscard]] std::size_t size() const noexcept {
+            return m_size;
+        }
+
+        [[maybe_unused]] [[nodiscard]] bool empty() const noexcept {
+            return m_size == 0;
+        }
+
+        // The number of levels, a tree with only a root leaf has height 1
+        [[maybe_unused]] [[nodiscard]] std::size_t height() const noexcept {
+            std::size_t levels = 0;
+
+            for (const node* current = m_root; current != nullptr; levels++) {
+                current = current->leaf ? nullptr : static_cast<const inner_node*>(current)->children[0];
+            }
+
+            return levels;
+        }
+
+        // Replaces the contents with sorted, which has to be in strictly ascending key order.
+        // The leaves are filled straight from it and the inner levels built on top, which is O(n) instead of
+        // O(n log n) for inserting one by one. Nodes are left a quarter empty so the inserts after it split less
+        [[maybe_unused]] void bulk_load(vector_template sorted) {
+            for (std::size_t i = 1; i < sorted.size(); i++) {
+                if (not (sorted[i - 1].first < sorted[i].first)) {
+                    // The tree would not be searchable
+                    throw "btree_map_error: bulk_load needs strictly ascending keys\n";
+                }
+            }
+
+            // Built next to the old tree, which is only replaced once the new one is complete
+            btree_map fresh;
+            fresh.build(std::move(sorted));
+            *this = std::move(fresh);
+        }
+
+        // Returns the pair with this key, or end()
+        [[maybe_unused]] iterator find(first_const_reference key) {
+            iterator found = lower_bound(key);
+            return found != end() and not (key < found->first) ? found : end();
+        }
+
+        [[maybe_unused]] const_iterator find(first_const_reference key) const {
+            const_iterator found = lower_bound(key);
+            return found != end() and not (key < found->first) ? found : end();
+        }
+
+        [[maybe_unused]] [[nodiscard]] bool contains(first_const_reference key) const {
+            return find(key) != end();
+        }
+
+        // Returns the first pair with a key that is not less than key, or end()
+        [[maybe_unused]] iterator lower_bound(first_const_reference key) {
+            return bound<false>(key);
+        }
+
+        [[maybe_unused]] const_iterator lower_bound(first_const_reference key) const {
+            return bound<false>(key);
+        }
+
+        // Returns the first pair with a key greater than key, or end()
+        [[maybe_unused]] iterator upper_bound(first_const_reference key) {
+            return bound<true>(key);
+        }
+
+        [[maybe_unused]] const_iterator upper_bound(first_const_reference key) const {
+            return bound<true>(key);
+        }
+
+        // Adds the pair only if the key is not in the map yet, the value is not touched otherwise.
+        // Returns an iterator to the pair with this key and whether it was inserted
+        template<typename... Args>
+        [[maybe_unused]] mc::pair<iterator, bool> try_emplace(first_const_reference key, Args&&... args) {
+            auto [found, inserted, slot] = insert_unique(key, [&args...] {
+                return second_type(std::forward<Args>(args)...);
+            });
+
+            return {found, inserted};
+        }
+
+        // Adds the pair if the key is not in the map yet, overwrites the value otherwise
+        [[maybe_unused]] mc::pair<iterator, bool> insert_or_assign(first_const_reference key, second_type value) {
+            auto [found, inserted, slot] = insert_unique(key, [&value] {
+                return std::move(value);
+            });
+
+            if (not inserted) {
+                slot->second = std::move(value);
+            }
+
+            return {found, inserted};
+        }
+
+        // Removes the pair with this key and returns how many pairs were removed (0 or 1)
+        [[maybe_unused]] std::size_t erase_key(first_const_reference key) {
+            if (m_root == nullptr) {
+                return 0;
+            }
+
+            path_entry path[MAX_DEPTH];
+            std::size_t depth = 0;
+            leaf_node* leaf = descend(key, path, depth);
+
+            std::size_t position = leaf_lower_bound(leaf, key);
+
+            if (position == leaf->count or key < leaf->slots[position].first) {
+                return 0;
+            }
+
+            std::move(leaf->slots + position + 1, leaf->slots + leaf->count, leaf->slots + position);
+            release_slot(leaf->slots[--leaf->count]);
+
+            if (--m_size == 0) {
+                erase();
+                return 1;
+            }
+
+            rebalance(path, depth, leaf);
+            return 1;
+        }
+
+        // Removes all pairs and frees all nodes
+        [[maybe_unused]] void erase() {
+            destroy(m_root);
+
+            m_root = nullptr;
+            m_first = nullptr;
+            m_size = 0;
+        }
+
+        iterator begin() noexcept {
+            return m_size == 0 ? end() : iterator{m_first, 0};
+        }
+
+        iterator end() noexcept {
+            return {};
+        }
+
+        const_iterator begin() const noexcept {
+            return m_size == 0 ? end() : const_iterator{m_first, 0};
+        }
+
+        const_iterator end() const noexcept {
+            return {};
+        }
+
+    private:
+        static leaf_node* as_leaf(node* current) {
+            return static_cast<leaf_node*>(current);
+        }
+
+        static inner_node* as_inner(node* current) {
+            return static_cast<inner_node*>(current);
+        }
+
+        // The child of inner that can hold key: the number of separators that are not greater than key.
+        // The nodes are small, so a linear scan beats a binary search
+        static std::size_t child_index(const inner_node* inner, first_const_reference key) {
+            std::size_t index = 0;
+
+            while (index < inner->count and not (key < inner->keys[index])) {
+                index++;
+            }
+
+            return index;
+        }
+
+        static std::size_t leaf_lower_bound(const leaf_node* leaf, first_const_reference key) {
+            std::size_t index = 0;
+
+            while (index < leaf->count and leaf->slots[index].first < key) {
+                index++;
+            }
+
+            return index;
+        }
+
+        static std::size_t leaf_upper_bound(const leaf_node* leaf, first_const_reference key) {
+            std::size_t index = 0;
+
+            while (index < leaf->count and not (key < leaf->slots[index].first)) {
+                index++;
+            }
+
+            return index;
+        }
+
+        // Overwrites a slot that is no longer used, so it does not keep the resources of a removed pair alive
+        static void release_slot(pair_template& slot) {
+            slot = pair_template{};
+        }
+
+        // Walks down to the leaf that can hold key and remembers the way
+        leaf_node* descend(first_const_reference key, path_entry* path, std::size_t& depth) const {
+            node* current = m_root;
+
+            while (not current->leaf) {
+                inner_node* inner = as_inner(current);
+                std::size_t index = child_index(inner, key);
+
+                path[depth++] = {inner, index};
+                current = inner->children[index];
+            }
+
+            return as_leaf(current);
+        }
+
+        // The nodes are only read here, a const map hands the result out as a const_iterator
+        template<bool Upper>
+        iterator bound(first_const_reference key) const {
+            if (m_root == nullptr) {
+                return {};
+            }
+
+            path_entry path[MAX_DEPTH];
+            std::size_t depth = 0;
+            leaf_node* leaf = descend(key, path, depth);
+
+            std::size_t index = Upper ? leaf_upper_bound(leaf, key) : leaf_lower_bound(leaf, key);
+
+            // Everything in this leaf is smaller, so the answer is the first pair of the next leaf
+            if (index == leaf->count) {
+                return {leaf->next, 0};
+            }
+
+            return {leaf, index};
+        }
+
+        struct insert_result {
+            iterator found;
+            bool inserted;
+            pair_template* slot;
+        };
+
+        // Inserts key with the value make() returns, unless key is already there
+        template<typename Make>
+        insert_result insert_unique(first_const_reference key, Make&& make) {
+            if (m_root == nullptr) {
+                m_first = new leaf_node();
+                m_root = m_first;
+            }
+
+            path_entry path[MAX_DEPTH];
+            std::size_t depth = 0;
+            leaf_node* leaf = descend(key, path, depth);
+
+            std::size_t position = leaf_lower_bound(leaf, key);
+
+            if (position < leaf->count and not (key < leaf->slots[position].first)) {
+                return {{leaf, position}, false, &leaf->slots[position]};
+            }
+
+            // Build the pair and allocate every node the splits need before the tree is changed,
+            // so a throwing constructor or a failed allocation leaves the tree as it was
+            pair_template entry{key, make()};
+
+            if (leaf->count == LEAF_SLOTS) {
+                std::size_t needed = 0;
+                std::size_t level = depth;
+
+                // Every full inner node on the way up splits as well, if they are all full the root does too
+                while (level > 0 and path[level - 1].parent->count == INNER_SLOTS) {
+                    needed++;
+                    level--;
+                }
+
+                if (level == 0) {
+                    needed++;
+                }
+
+                auto right_leaf = std::make_unique<leaf_node>();
+                std::unique_ptr<inner_node> spares[MAX_DEPTH + 1];
+
+                for (std::size_t i = 0; i < needed; i++) {
+                    spares[i] = std::make_unique<inner_node>();
+                }
+
+                leaf_node* right = right_leaf.release();
+                split_leaf(leaf, right);
+
+                // The new pair goes to whichever half it belongs in, the first key of right stays the separator
+                TKey separator = right->slots[0].first;
+
+                if (position > leaf->count) {
+                    position -= leaf->count;
+                    leaf = right;
+                }
+
+                insert_into_parents(path, depth, std::move(separator), right, spares);
+            }
+
+            std::move_backward(leaf->slots + position, leaf->slots + leaf->count, leaf->slots + leaf->count + 1);
+            leaf->slots[position] = std::move(entry);
+            leaf->count++;
+
+            m_size++;
+            return {{leaf, position}, true, &leaf->slots[position]};
+        }
+
+        // Moves the upper half of a full leaf to right, which is linked in after it
+        static void split_leaf(leaf_node* leaf, leaf_node* right) {
+            std::size_t middle = leaf->count / 2;
+
+            std::move(leaf->slots + middle, leaf->slots + leaf->count, right->slots);
+
+            right->count = static_cast<std::uint16_t>(leaf->count - middle);
+            leaf->count = static_cast<std::uint16_t>(middle);
+
+            right->next = leaf->next;
+            leaf->next = right;
+        }
+
+        // Adds separator and the new child right to the parent at the end of path, splitting full parents on the way up
+        void insert_into_parents(path_entry* path, std::size_t depth, TKey separator, node* right,
+                                 std::unique_ptr<inner_node>* spares) {
+            for (std::size_t level = depth; level-- > 0;) {
+                inner_node* parent = path[level].parent;
+                std::size_t index = path[level].index;
+
+                if (parent->count < INNER_SLOTS) {
+                    inner_insert(parent, index, std::move(separator), right);
+                    return;
+                }
+
+                inner_node* sibling = (spares++)->release();
+                TKey up = split_inner(parent, sibling);
+
+                if (index <= parent->count) {
+                    inner_insert(parent, index, std::move(separator), right);
+                } else {
+                    inner_insert(sibling, index - parent->count - 1, std::move(separator), right);
+                }
+
+                separator = std::move(up);
+                right = sibling;
+            }
+
+            // The root was split, the tree grows one level
+            inner_node* root = spares->release();
+
+            root->keys[0] = std::move(separator);
+            root->children[0] = m_root;
+            root->children[1] = right;
+            root->count = 1;
+
+            m_root = root;
+        }
+
+        // Puts key at index and child right of it
+        static void inner_insert(inner_node* inner, std::size_t index, TKey key, node* child) {
+            std::move_backward(inner->keys + index, inner->keys + inner->count, inner->keys + inner->count + 1);
+            std::copy_backward(inner->children + index + 1, inner->children + inner->count + 1, inner->children + inner->count + 2);
+
+            inner->keys[index] = std::move(key);
+            inner->children[index + 1] = child;
+            inner->count++;
+        }
+
+        // Moves the upper half of a full inner node to sibling and returns the middle key, which moves up a level
+        static TKey split_inner(inner_node* inner, inner_node* sibling) {
+            std::size_t middle = inner->count / 2;
+
+            std::move(inner->keys + middle + 1, inner->keys + inner->count, sibling->keys);
+            std::copy(inner->children + middle + 1, inner->children + inner->count + 1, sibling->children);
+
+            sibling->count = static_cast<std::uint16_t>(inner->count - middle - 1);
+            inner->count = static_cast<std::uint16_t>(middle);
+
+            return std::move(inner->keys[middle]);
+        }
+
+        // Removes key index and the child right of it
+        static void inner_erase(inner_node* inner, std::size_t index) {
+            std::move(inner->keys + index + 1, inner->keys + inner->count, inner->keys + index);
+            std::copy(inner->children + index + 2, inner->children + inner->count + 1, inner->children + index + 1);
+
+            inner->count--;
+        }
+
+        // Walks back up from a leaf that lost a pair and fixes every node that got less than half full
+        void rebalance(path_entry* path, std::size_t depth, node* current) {
+            for (std::size_t level = depth; level-- > 0;) {
+                if (current->count >= (current->leaf ? LEAF_MIN : INNER_MIN)) {
+                    return;
+                }
+
+                inner_node* parent = path[level].parent;
+                std::size_t index = path[level].index;
+
+                if (current->leaf) {
+                    fix_leaf(parent, index);
+                } else {
+                    fix_inner(parent, index);
+                }
+
+                current = parent;
+            }
+
+            // A root without keys only has one child left, which becomes the new root
+            if (not m_root->leaf and m_root->count == 0) {
+                inner_node* old_root = as_inner(m_root);
+                m_root = old_root->children[0];
+                delete old_root;
+            }
+        }
+
+        // Refills the leaf at parent->children[index] from a neighbour, or merges it with one
+        void fix_leaf(inner_node* parent, std::size_t index) {
+            leaf_node* leaf = as_leaf(parent->children[index]);
+
+            if (index > 0) {
+                leaf_node* left = as_leaf(parent->children[index - 1]);
+
+                if (left->count > LEAF_MIN) {
+                    std::move_backward(leaf->slots, leaf->slots + leaf->count, leaf->slots + leaf->count + 1);
+                    leaf->slots[0] = std::move(left->slots[left->count - 1]);
+                    release_slot(left->slots[--left->count]);
+                    leaf->count++;
+
+                    parent->keys[index - 1] = leaf->slots[0].first;
+                    return;
+                }
+            }
+
+            if (index < parent->count) {
+                leaf_node* right = as_leaf(parent->children[index + 1]);
+
+                if (right->count > LEAF_MIN) {
+                    leaf->slots[leaf->count++] = std::move(right->slots[0]);
+                    std::move(right->slots + 1, right->slots + right->count, right->slots);
+                    release_slot(right->slots[--right->count]);
+
+                    parent->keys[index] = right->slots[0].first;
+                    return;
+                }
+            }
+
+            merge_leaves(parent, index > 0 ? index - 1 : index);
+        }
+
+        // Moves everything of children[index + 1] into children[index] and frees it
+        void merge_leaves(inner_node* parent, std::size_t index) {
+            leaf_node* left = as_leaf(parent->children[index]);
+            leaf_node* right = as_leaf(parent->children[index + 1]);
+
+            std::move(right->slots, right->slots + right->count, left->slots + left->count);
+            left->count = static_cast<std::uint16_t>(left->count + right->count);
+            left->next = right->next;
+
+            delete right;
+            inner_erase(parent, index);
+        }
+
+        // Same as fix_leaf, but keys rotate through the parent because inner nodes do not hold pairs
+        void fix_inner(inner_node* parent, std::size_t index) {
+            inner_node* inner = as_inner(parent->children[index]);
+
+            if (index > 0) {
+                inner_node* left = as_inner(parent->children[index - 1]);
+
+                if (left->count > INNER_MIN) {
+                    std::move_backward(inner->keys, inner->keys + inner->count, inner->keys + inner->count + 1);
+                    std::copy_backward(inner->children, inner->children + inner->count + 1, inner->children + inner->count + 2);
+
+                    inner->keys[0] = std::move(parent->keys[index - 1]);
+                    inner->children[0] = left->children[left->count];
+                    inner->count++;
+
+                    parent->keys[index - 1] = std::move(left->keys[left->count - 1]);
+                    left->count--;
+                    return;
+                }
+            }
+
+            if (index < parent->count) {
+                inner_node* right = as_inner(parent->children[index + 1]);
+
+                if (right->count > INNER_MIN) {
+                    inner->keys[inner->count] = std::move(parent->keys[index]);
+                    inner->children[inner->count + 1] = right->children[0];
+                    inner->count++;
+
+                    parent->keys[index] = std::move(right->keys[0]);
+                    std::move(right->keys + 1, right->keys + right->count, right->keys);
+                    std::copy(right->children + 1, right->children + right->count + 1, right->children);
+                    right->count--;
+                    return;
+                }
+            }
+
+            merge_inner(parent, index > 0 ? index - 1 : index);
+        }
+
+        // Moves the separator and everything of children[index + 1] into children[index] and frees it
+        void merge_inner(inner_node* parent, std::size_t index) {
+            inner_node* left = as_inner(parent->children[index]);
+            inner_node* right = as_inner(parent->children[index + 1]);
+
+            left->keys[left->count] = std::move(parent->keys[index]);
+            std::move(right->keys, right->keys + right->count, left->keys + left->count + 1);
+            std::copy(right->children, right->children + right->count + 1, left->children + left->count + 1);
+            left->count = static_cast<std::uint16_t>(left->count + 1 + right->count);
+
+            delete right;
+            inner_erase(parent, index);
+        }
+
+        // Builds the tree bottom up from pairs that are known to be in strictly ascending order, on an empty tree.
+        // Until the root is set the nodes are only reachable from here, so if a move or an allocation throws
+        // the leaves (through their links) and the inner nodes built so far are freed before it goes on
+        void build(vector_template sorted) {
+            std::size_t count = sorted.size();
+
+            if (count == 0) {
+                return;
+            }
+
+            // Spread the pairs evenly over as many leaves as a 3/4 fill needs
+            std::size_t per_leaf = std::max<std::size_t>(1, LEAF_SLOTS * 3 / 4);
+            std::size_t leaves = (count + per_leaf - 1) / per_leaf;
+
+            leaf_node* first = nullptr;
+            mc::vector<inner_node*> inners;
+
+            try {
+                mc::vector<node*> level(leaves);
+                mc::vector<TKey> lowest(leaves);
+
+                leaf_node* previous = nullptr;
+                std::size_t next = 0;
+
+                for (std::size_t i = 0; i < leaves; i++) {
+                    std::size_t take = count / leaves + (i < count % leaves ? 1 : 0);
+                    auto leaf = std::make_unique<leaf_node>();
+
+                    std::move(sorted.begin() + next, sorted.begin() + next + take, leaf->slots);
+                    leaf->count = static_cast<std::uint16_t>(take);
+                    next += take;
+
+                    lowest.push_back(leaf->slots[0].first);
+
+                    if (previous == nullptr) {
+                        first = leaf.get();
+                    } else {
+                        previous->next = leaf.get();
+                    }
+
+                    previous = leaf.release();
+                    level.push_back(previous);
+                }
+
+                // Every inner level groups the nodes of the level below, with the lowest key of each child as separator
+                std::size_t per_inner = std::max<std::size_t>(2, (INNER_SLOTS + 1) * 3 / 4);
+
+                while (level.size() > 1) {
+                    std::size_t parents = (level.size() + per_inner - 1) / per_inner;
+
+                    mc::vector<node*> upper(parents);
+                    mc::vector<TKey> upper_lowest(parents);
+
+                    std::size_t child = 0;
+
+                    for (std::size_t i = 0; i < parents; i++) {
+                        std::size_t take = level.size() / parents + (i < level.size() % parents ? 1 : 0);
+                        auto inner = std::make_unique<inner_node>();
+
+                        inner->children[0] = level[child];
+
+                        for (std::size_t c = 1; c < take; c++) {
+                            inner->keys[c - 1] = std::move(lowest[child + c]);
+                            inner->children[c] = level[child + c];
+                        }
+
+                        inner->count = static_cast<std::uint16_t>(take - 1);
+
+                        upper_lowest.push_back(std::move(lowest[child]));
+                        inners.push_back(inner.get());
+                        upper.push_back(inner.release());
+                        child += take;
+                    }
+
+                    level = std::move(upper);
+                    lowest = std::move(upper_lowest);
+                }
+
+                m_root = level[0];
+            } catch (...) {
+                while (first != nullptr) {
+                    delete std::exchange(first, first->next);
+                }
+
+                for (inner_node* inner : inners) {
+                    delete inner;
+                }
+
+                throw;
+            }
+
+            m_first = first;
+            m_size = count;
+        }
+
+        static void destroy(node* current) {
+            if (current == nullptr) {
+                return;
+            }
+
+            if (current->leaf) {
+                delete as_leaf(current);
+                return;
+            }
+
+            inner_node* inner = as_inner(current);
+
+            for (std::size_t i = 0; i <= inner->count; i++) {
+                destroy(inner->children[i]);
+            }
+
+            delete inner;
+        }
+
+        node* m_root{nullptr};
+
+        // The leftmost leaf, where iteration starts
+        leaf_node* m_first{nullptr};
+
+        std::size_t m_size{0};
+    };
+
+}
+
+#endif //APC_LIBRARY_BTREE_MAP_H
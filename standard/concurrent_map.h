@@ -0,0 +1,284 @@
+//
+// Created by Camiel Verdult on 17/10/2026.
+//
+
+#ifndef APC_LIBRARY_CONCURRENT_MAP_H
+#define APC_LIBRARY_CONCURRENT_MAP_H
+
+#include "hash.h"
+#include "map.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <thread>
+#include <utility>
+
+namespace mc {
+
+    // A hash map that can be used from many threads at once without one big lock around it.
+    // The keys are spread over a power of two number of shards, each shard is an mc::map with its own
+    // reader/writer lock. Threads working on keys in different shards never wait for each other.
+    //
+    // find() and contains() do not take the lock at all. Every shard has a version that is odd while a writer is
+    // changing it, a reader that sees an even version announces itself, checks the version again and then reads the
+    // shard directly. A writer makes the version odd and waits for the announced readers to finish before it touches
+    // anything, so readers never see a half-done write or memory that is being freed. A reader that finds a writer
+    // busy goes to the shared lock without announcing itself, so a writer only waits for the readers that were
+    // already there and a steady stream of new readers can not starve it.
+    //
+    // The announcements are spread over a few counters per shard, each on its own cache line, and every thread
+    // always uses the same one. Readers on different cores then do not fight over one cache line, like they would
+    // over the lock or a single counter.
+    //
+    // Nothing hands out pointers into a shard, because another thread could move the pairs as soon as the lock is
+    // released. find() returns a copy of the value and update() runs a function on the value while the lock is held
+    template<typename TKey, typename TValue>
+    class concurrent_map {
+    public:
+
+        using first_type = TKey;
+        using first_const_reference = const TKey&;
+
+        using second_type = TValue;
+
+        using map_template = mc::map<TKey, TValue>;
+
+        static constexpr std::size_t DEFAULT_SHARDS{64};
+
+        // Reader counters per shard, threads beyond this many share them
+        static constexpr std::size_t READER_STRIPES{8};
+
+        // shard_count is rounded up to a power of two, use more shards than threads to keep collisions rare
+        explicit concurrent_map(std::size_t shard_count = DEFAULT_SHARDS) {
+            while (m_shard_count < shard_count) {
+                m_shard_count *= 2;
+            }
+
+            m_shards = std::make_unique<shard[]>(m_shard_count);
+        }
+
+        // Shards hold locks, which can not be copied or moved
+        concurrent_map(const concurrent_map&) = delete;
+        concurrent_map& operator=(const concurrent_map&) = delete;
+
+        [[maybe_unused]] [[nodiscard]] std::size_t shard_count() const noexcept {
+            return m_shard_count;
+        }
+
+        // Adds up the sizes of all shards. Other threads can change the map meanwhile,
+        // so this is only exact when nobody is writing
+        [[maybe_unused]] [[nodiscard]] std::size_t size() const {
+            std::size_t total = 0;
+
+            for (std::size_t i = 0; i < m_shard_count; i++) {
+                std::shared_lock lock{m_shards[i].lock};
+                total += m_shards[i].map.size();
+            }
+
+            return total;
+        }
+
+        // Returns a copy of the value of key, or nothing if the key is not in the map.
+        // Like mc::map, find/contains/erase take any key type mc::hash<TKey> hashes transparently
+        template<typename Key = TKey> requires lookup_key<Key, TKey>
+        [[maybe_unused]] std::optional<second_type> find(const Key& key) const {
+            return read(shard_of(key), [&key](const map_template& map) -> std::optional<second_type> {
+                const auto* found = map.find(key);
+
+                if (found == map.end()) {
+                    return std::nullopt;
+                }
+
+                return found->second;
+            });
+        }
+
+        template<typename Key = TKey> requires lookup_key<Key, TKey>
+        [[maybe_unused]] [[nodiscard]] bool contains(const Key& key) const {
+            return read(shard_of(key), [&key](const map_template& map) {
+                return map.contains(key);
+            });
+        }
+
+        // Adds the pair if the key is not in the map yet, overwrites the value otherwise.
+        // Returns whether the key was inserted
+        [[maybe_unused]] bool insert_or_assign(first_const_reference key, second_type value) {
+            shard& owner = shard_of(key);
+            write_guard guard{owner};
+
+            return owner.map.insert_or_assign(key, std::move(value)).second;
+        }
+
+        // Adds the pair only if the key is not in the map yet, returns whether it was inserted
+        [[maybe_unused]] bool try_emplace(first_const_reference key, second_type value) {
+            shard& owner = shard_of(key);
+            write_guard guard{owner};
+
+            return owner.map.try_emplace(key, std::move(value)).second;
+        }
+
+        // Removes the pair with this key and returns how many pairs were removed (0 or 1)
+        template<typename Key = TKey> requires lookup_key<Key, TKey>
+        [[maybe_unused]] std::size_t erase(const Key& key) {
+            shard& owner = shard_of(key);
+            write_guard guard{owner};
+
+            return owner.map.erase_key(key);
+        }
+
+        // Calls fn(value) on the value of key while its shard is locked, so read-modify-write is atomic.
+        // Returns whether the key was found, fn is not called otherwise
+        template<typename Function>
+        [[maybe_unused]] bool update(first_const_reference key, Function&& fn) {
+            shard& owner = shard_of(key);
+            write_guard guard{owner};
+
+            auto* found = owner.map.find(key);
+
+            if (found == owner.map.end()) {
+                return false;
+            }
+
+            std::invoke(std::forward<Function>(fn), found->second);
+            return true;
+        }
+
+        // Calls fn(const mc::map&) for every shard in turn, with that shard locked for reading.
+        // Each shard is a consistent snapshot, but other shards can change while fn runs
+        template<typename Function>
+        [[maybe_unused]] void for_each_shard(Function&& fn) const {
+            for (std::size_t i = 0; i < m_shard_count; i++) {
+                std::shared_lock lock{m_shards[i].lock};
+                std::invoke(fn, static_cast<const map_template&>(m_shards[i].map));
+            }
+        }
+
+        [[maybe_unused]] void erase() {
+            for (std::size_t i = 0; i < m_shard_count; i++) {
+                write_guard guard{m_shards[i]};
+                m_shards[i].map.erase();
+            }
+        }
+
+    private:
+        // Every shard gets its own cache lines, otherwise taking the lock of one shard
+        // would invalidate the lock of its neighbour in the caches of other cores
+        //
+        // Readers without the lock call the const find/contains of the map. Those rebuild a stale hash index, which
+        // would be a data race with nothing but readers around, so a shard must never be left with a stale index.
+        // That holds because writers only use insert_or_assign, try_emplace, erase_key, the non-const find, and
+        // erase(), which all keep the index up to date. for_each_shard only hands out a const map.
+        // Do not use reindex(), insert(), sort() or anything else that marks the index stale on a shard
+        struct alignas(64) reader_count {
+            std::atomic<std::size_t> value{0};
+        };
+
+        struct alignas(64) shard {
+            mutable std::shared_mutex lock;
+
+            // Odd while a writer is changing the map
+            std::atomic<std::uint64_t> version{0};
+
+            map_template map;
+
+            // Readers that are reading the map without the lock right now, added up over all stripes
+            mutable reader_count readers[READER_STRIPES];
+        };
+
+        // Takes the lock of a shard for writing and keeps the lock-free readers out until it is destroyed
+        class write_guard {
+        public:
+            explicit write_guard(shard& owner) : m_owner{owner}, m_lock{owner.lock} {
+                // seq_cst on both sides: either a reader sees the odd version, or we see its announcement
+                m_owner.version.fetch_add(1, std::memory_order_seq_cst);
+
+                for (auto& count : m_owner.readers) {
+                    while (count.value.load(std::memory_order_seq_cst) != 0) {
+                        std::this_thread::yield();
+                    }
+                }
+            }
+
+            ~write_guard() {
+                m_owner.version.fetch_add(1, std::memory_order_release);
+            }
+
+            write_guard(const write_guard&) = delete;
+            write_guard& operator=(const write_guard&) = delete;
+
+        private:
+            shard& m_owner;
+            std::unique_lock<std::shared_mutex> m_lock;
+        };
+
+        // Calls fn(const map&) on the map of a shard. Without a writer busy on the shard this takes no lock,
+        // otherwise it waits for the writer on the shared lock like before
+        template<typename Function>
+        auto read(const shard& owner, Function&& fn) const {
+            if ((owner.version.load(std::memory_order_acquire) & 1) == 0) {
+                auto& count = owner.readers[reader_stripe()].value;
+                count.fetch_add(1, std::memory_order_seq_cst);
+
+                // Leaves again when fn is done or throws
+                struct announcement {
+                    std::atomic<std::size_t>& count;
+
+                    ~announcement() {
+                        count.fetch_sub(1, std::memory_order_release);
+                    }
+                } announced{count};
+
+                // A writer can have come in between, it could already be past our counter
+                if ((owner.version.load(std::memory_order_seq_cst) & 1) == 0) {
+                    return std::invoke(fn, static_cast<const map_template&>(owner.map));
+                }
+            }
+
+            std::shared_lock lock{owner.lock};
+            return std::invoke(fn, static_cast<const map_template&>(owner.map));
+        }
+
+        // The counter a thread announces itself on, threads get one in turn the first time they read
+        static std::size_t reader_stripe() {
+            static std::atomic<std::size_t> next_stripe{0};
+            thread_local const std::size_t stripe = next_stripe.fetch_add(1, std::memory_order_relaxed) % READER_STRIPES;
+
+            return stripe;
+        }
+
+        // mc::map uses the top bits of a Fibonacci hash for its slots, so pick the shard with the low bits
+        // of a different mix. Otherwise all keys of one shard would land in the same part of its index
+        template<typename Key>
+        std::size_t shard_index(const Key& key) const {
+            auto hash = static_cast<std::uint64_t>(mc::hash<TKey>{}(key));
+
+            hash ^= hash >> 33;
+            hash *= 0xff51afd7ed558ccdull;
+            hash ^= hash >> 33;
+
+            return static_cast<std::size_t>(hash) & (m_shard_count - 1);
+        }
+
+        template<typename Key>
+        shard& shard_of(const Key& key) {
+            return m_shards[shard_index(key)];
+        }
+
+        template<typename Key>
+        const shard& shard_of(const Key& key) const {
+            return m_shards[shard_index(key)];
+        }
+
+        std::size_t m_shard_count{1};
+        std::unique_ptr<shard[]> m_shards;
+    };
+
+}
+
+#endif //APC_LIBRARY_CONCURRENT_MAP_H
@@ -0,0 +1,338 @@
+//
+// Created by Camiel Verdult on 17/10/2026.
+//
+
+#ifndef APC_LIBRARY_CONCURRENT_VECTOR_H
+#define APC_LIBRARY_CONCURRENT_VECTOR_H
+
+#include "instrumentation.h"
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace mc {
+
+    // An append-only vector that many threads can push back into at the same time without locks.
+    // The elements live in segments that double in size (32, 64, 128, ...) and are never moved, so a reference to
+    // an element stays valid for the lifetime of the vector, even while other threads keep appending.
+    //
+    // push_back claims a slot with one atomic fetch_add, the segment holding it is allocated by whichever thread
+    // gets there first. Every slot has a ready flag that is set once its element is constructed, and size() is the
+    // length of the run of ready slots at the front. A thread that finishes its slot moves size() past every ready
+    // slot it finds, so no thread ever waits for a slower one: an element that is done before the ones in front of
+    // it simply becomes visible when they are. Reading [0, size()) or iterating is safe while other threads append.
+    // Removing elements is not, see erase()
+    template <typename T>
+    class concurrent_vector {
+        // The element is built before a slot is claimed and then moved in, so a throwing constructor can not leave
+        // a claimed slot behind that size() could never move past
+        static_assert(std::is_nothrow_move_constructible_v<T>, "concurrent_vector moves elements into claimed slots");
+
+        static constexpr std::size_t FIRST_BITS{5};
+        static constexpr std::size_t FIRST_SEGMENT{std::size_t{1} << FIRST_BITS};
+        static constexpr std::size_t MAX_SEGMENTS{64 - FIRST_BITS};
+
+    public:
+        using value_type = T;
+        using pointer = T*;
+        using const_pointer = const T*;
+        using reference = T&;
+        using const_reference = const T&;
+
+        // Walks [0, size()) as it was when begin() was called, elements appended afterwards are not visited
+        template <bool Const>
+        class basic_iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = std::conditional_t<Const, const T*, T*>;
+            using reference = std::conditional_t<Const, const T&, T&>;
+
+            using owner_pointer = std::conditional_t<Const, const concurrent_vector*, concurrent_vector*>;
+
+            basic_iterator() = default;
+            basic_iterator(owner_pointer owner, std::size_t index) : m_owner{owner}, m_index{index} {}
+
+            reference operator*() const {
+                return (*m_owner)[m_index];
+            }
+
+            pointer operator->() const {
+                return &(*m_owner)[m_index];
+            }
+
+            basic_iterator& operator++() {
+                m_index++;
+                return *this;
+            }
+
+            basic_iterator operator++(int) {
+                basic_iterator previous = *this;
+                m_index++;
+                return previous;
+            }
+
+            bool operator==(const basic_iterator& other) const {
+                return m_index == other.m_index;
+            }
+
+        private:
+            owner_pointer m_owner{nullptr};
+            std::size_t m_index{0};
+        };
+
+        using iterator = basic_iterator<false>;
+        using const_iterator = basic_iterator<true>;
+
+        concurrent_vector() = default;
+
+        // The atomics and the threads that might be appending make copies and moves meaningless
+        concurrent_vector(const concurrent_vector&) = delete;
+        concurrent_vector& operator=(const concurrent_vector&) = delete;
+
+        ~concurrent_vector() {
+            if (m_segments[0].load(std::memory_order_relaxed) != nullptr) {
+                std::size_t slots = capacity();
+                std::size_t count = size();
+                instrumentation::record<concurrent_vector>(instrumentation::event_kind::release, (slots - count) * sizeof(T), slots, count);
+            }
+
+            erase();
+
+            for (std::size_t s = 0; s < MAX_SEGMENTS; s++) {
+                pointer segment = m_segments[s].load(std::memory_order_relaxed);
+
+                if (segment != nullptr) {
+                    instrumentation::record<concurrent_vector>(instrumentation::event_kind::deallocate, segment_size(s) * sizeof(T), segment_size(s), 0);
+                    std::allocator<T>{}.deallocate(segment, segment_size(s));
+                }
+
+                delete[] m_ready[s].load(std::memory_order_relaxed);
+            }
+        }
+
+        // The number of elements at the front that are fully constructed, all of [0, size()) can be read
+        [[maybe_unused]] [[nodiscard]] std::size_t size() const noexcept {
+            return m_size.load(std::memory_order_acquire);
+        }
+
+        // The number of elements the allocated segments can hold. Segments are allocated in order,
+        // except when two threads race for neighbouring segments, so this is a lower bound while appends run
+        [[maybe_unused]] [[nodiscard]] std::size_t capacity() const noexcept {
+            std::size_t total = 0;
+
+            for (std::size_t s = 0; s < MAX_SEGMENTS and m_segments[s].load(std::memory_order_acquire) != nullptr; s++) {
+                total += segment_size(s);
+            }
+
+            return total;
+        }
+
+        reference push_back(const_reference entry) {
+            return emplace_back(entry);
+        }
+
+        reference push_back(value_type&& entry) {
+            return emplace_back(std::move(entry));
+        }
+
+        // Constructs the new element from args and returns a reference to it, which stays valid
+        template <typename... Args>
+        reference emplace_back(Args&&... args) {
+            instrumentation::record_construct<concurrent_vector, T, Args...>();
+            value_type entry(std::forward<Args>(args)...);
+            return place(std::move(entry));
+        }
+
+        // Allocates the segments for the first new_capacity elements up front, safe to call while appending
+        [[maybe_unused]] void reserve(std::size_t new_capacity) {
+            if (new_capacity == 0) {
+                return;
+            }
+
+            std::size_t last = segment_of(new_capacity - 1);
+
+            for (std::size_t s = 0; s <= last; s++) {
+                segment(s);
+                ready_flags(s);
+            }
+        }
+
+        [[maybe_unused]] reference at(std::size_t index) {
+            if (index >= size()) {
+                // Index is out of bounds
+                throw "concurrent_vector_error: at(i) is out of bounds\n";
+            }
+
+            return (*this)[index];
+        }
+
+        [[maybe_unused]] const_reference at(std::size_t index) const {
+            if (index >= size()) {
+                // Index is out of bounds
+                throw "concurrent_vector_error: at(i) is out of bounds\n";
+            }
+
+            return (*this)[index];
+        }
+
+        // Only valid for index < size()
+        [[maybe_unused]] reference operator[](std::size_t index) noexcept {
+            std::size_t s = segment_of(index);
+            return m_segments[s].load(std::memory_order_acquire)[offset_in(index, s)];
+        }
+
+        [[maybe_unused]] const_reference operator[](std::size_t index) const noexcept {
+            std::size_t s = segment_of(index);
+            return m_segments[s].load(std::memory_order_acquire)[offset_in(index, s)];
+        }
+
+        // Destroys all elements but keeps the segments. This is the one function that
+        // must not run while other threads append or read
+        [[maybe_unused]] void erase() noexcept {
+            std::size_t count = m_size.load(std::memory_order_acquire);
+
+            for (std::size_t i = 0; i < count; i++) {
+                std::destroy_at(&(*this)[i]);
+                ready_flag(i)->store(false, std::memory_order_relaxed);
+            }
+
+            m_size.store(0, std::memory_order_relaxed);
+            m_claimed.store(0, std::memory_order_relaxed);
+        }
+
+        iterator begin() noexcept {
+            return {this, 0};
+        }
+
+        iterator end() noexcept {
+            return {this, size()};
+        }
+
+        const_iterator begin() const noexcept {
+            return {this, 0};
+        }
+
+        const_iterator end() const noexcept {
+            return {this, size()};
+        }
+
+    private:
+        // Element i lives at i + FIRST_SEGMENT counted over all segments, so segment s starts at
+        // (FIRST_SEGMENT << s) - FIRST_SEGMENT and the segment number is just the position of the highest bit
+        static std::size_t segment_of(std::size_t index) noexcept {
+            return static_cast<std::size_t>(std::bit_width(index + FIRST_SEGMENT)) - 1 - FIRST_BITS;
+        }
+
+        static std::size_t offset_in(std::size_t index, std::size_t s) noexcept {
+            return index + FIRST_SEGMENT - (FIRST_SEGMENT << s);
+        }
+
+        static std::size_t segment_size(std::size_t s) noexcept {
+            return FIRST_SEGMENT << s;
+        }
+
+        // Returns segment s, allocating it if no thread has done so yet
+        pointer segment(std::size_t s) {
+            pointer current = m_segments[s].load(std::memory_order_acquire);
+
+            if (current != nullptr) {
+                return current;
+            }
+
+            pointer fresh = std::allocator<T>{}.allocate(segment_size(s));
+
+            if (m_segments[s].compare_exchange_strong(current, fresh, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                // Only the segment that is kept counts, the capacity is that of all segments up to this one
+                instrumentation::record<concurrent_vector>(instrumentation::event_kind::allocate, segment_size(s) * sizeof(T),
+                                                           segment_size(s + 1) - FIRST_SEGMENT, 0);
+                return fresh;
+            }
+
+            // Another thread was faster, use its segment
+            std::allocator<T>{}.deallocate(fresh, segment_size(s));
+            return current;
+        }
+
+        // Returns the ready flags of segment s, allocating them (all false) if no thread has done so yet
+        std::atomic<bool>* ready_flags(std::size_t s) {
+            std::atomic<bool>* current = m_ready[s].load(std::memory_order_acquire);
+
+            if (current != nullptr) {
+                return current;
+            }
+
+            auto* fresh = new std::atomic<bool>[segment_size(s)]();
+
+            if (m_ready[s].compare_exchange_strong(current, fresh, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                return fresh;
+            }
+
+            delete[] fresh;
+            return current;
+        }
+
+        // The ready flag of slot index, or nullptr if its segment has no flags yet (so it is not ready either)
+        std::atomic<bool>* ready_flag(std::size_t index) const noexcept {
+            std::size_t s = segment_of(index);
+            std::atomic<bool>* flags = m_ready[s].load(std::memory_order_acquire);
+            return flags != nullptr ? flags + offset_in(index, s) : nullptr;
+        }
+
+        // Once a slot is claimed it has to be published, otherwise size() could never move past it.
+        // That is why this is noexcept: running out of memory for a new segment here terminates
+        reference place(value_type&& entry) noexcept {
+            std::size_t index = m_claimed.fetch_add(1, std::memory_order_relaxed);
+            std::size_t s = segment_of(index);
+
+            pointer slot = segment(s) + offset_in(index, s);
+            std::construct_at(slot, std::move(entry));
+
+            // seq_cst on the flag and on m_size: either we see m_size reach our slot below, or the thread that moved
+            // it there sees our flag. Without that both could miss each other and size() would get stuck
+            ready_flags(s)[offset_in(index, s)].store(true, std::memory_order_seq_cst);
+            publish();
+
+            return *slot;
+        }
+
+        // Moves m_size past every ready slot at the front. Any thread can do this for any other thread,
+        // a failed compare_exchange means someone else moved it and we continue from where they got
+        void publish() noexcept {
+            std::size_t published = m_size.load(std::memory_order_seq_cst);
+
+            while (published < m_claimed.load(std::memory_order_relaxed)) {
+                std::atomic<bool>* flag = ready_flag(published);
+
+                if (flag == nullptr or not flag->load(std::memory_order_seq_cst)) {
+                    // The thread writing this slot publishes it, and everything ready after it, when it is done
+                    return;
+                }
+
+                if (m_size.compare_exchange_weak(published, published + 1, std::memory_order_seq_cst)) {
+                    published++;
+                }
+            }
+        }
+
+        std::atomic<pointer> m_segments[MAX_SEGMENTS]{};
+
+        // One flag per slot in m_segments, set once the element in that slot is constructed
+        std::atomic<std::atomic<bool>*> m_ready[MAX_SEGMENTS]{};
+
+        // Slots handed out to appending threads, can be ahead of m_size
+        std::atomic<std::size_t> m_claimed{0};
+
+        // Elements that are constructed and visible to other threads
+        std::atomic<std::size_t> m_size{0};
+    };
+
+}
+
+#endif //APC_LIBRARY_CONCURRENT_VECTOR_H
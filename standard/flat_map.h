@@ -0,0 +1,251 @@
+//
+// Created by Camiel Verdult on 17/10/2026.
+//
+
+#ifndef APC_LIBRARY_FLAT_MAP_H
+#define APC_LIBRARY_FLAT_MAP_H
+
+#include "pair.h"
+#include "sort.h"
+#include "vector.h"
+
+#include <algorithm>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+
+namespace mc {
+
+    // A map that keeps its pairs in one mc::vector, sorted by key after every operation.
+    // Lookups are a binary search over contiguous memory, which for read-mostly tables beats both node based maps
+    // (one cache miss per node) and hash tables (memory for empty slots). Inserting in the middle is O(n), so fill it
+    // with the bulk insert(first, last) where possible. Like std::map every key is in the map at most once
+    template<typename TKey, typename TValue, typename Allocator = std::allocator<mc::pair<TKey, TValue>>>
+    class flat_map {
+    public:
+
+        using first_type = TKey;
+        using first_const_reference = const TKey&;
+
+        using second_type = TValue;
+
+        using pair_template = mc::pair<TKey, TValue>;
+        using pair_template_pointer = pair_template*;
+        using pair_template_reference = pair_template&;
+        using pair_template_const_reference = const pair_template&;
+
+        using allocator_type = Allocator;
+
+        using vector_template = mc::vector<pair_template, growth::doubling, Allocator>;
+        using vector_template_const_reference = const vector_template&;
+
+        // Default constructor
+        explicit flat_map(const Allocator& allocator = Allocator()) : m_vector (allocator) {}
+
+        // initializer list constructor, the list does not have to be sorted
+        flat_map(std::initializer_list<pair_template> list, const Allocator& allocator = Allocator()) : flat_map(allocator) {
+            insert(list.begin(), list.end());
+        }
+
+        [[maybe_unused]] [[nodiscard]] std::size_t capacity() const {
+            return m_vector.capacity();
+        }
+
+        [[maybe_unused]] [[nodiscard]] std::size_t size() const {
+            return m_vector.size();
+        }
+
+        [[maybe_unused]] [[nodiscard]] allocator_type get_allocator() const {
+            return m_vector.get_allocator();
+        }
+
+        // Only a const view, changing the pairs in place could break the order
+        [[maybe_unused]] vector_template_const_reference raw() const {
+            return m_vector;
+        }
+
+        [[maybe_unused]] void reserve(std::size_t new_capacity) {
+            m_vector.reserve(new_capacity);
+        }
+
+        // Returns the first pair with a key that is not less than key, or end()
+        [[maybe_unused]] const pair_template* lower_bound(first_const_reference key) const {
+            return std::lower_bound(begin(), end(), key, [](pair_template_const_reference entry, first_const_reference k) {
+                return entry.first < k;
+            });
+        }
+
+        // Returns the first pair with a key greater than key, or end()
+        [[maybe_unused]] const pair_template* upper_bound(first_const_reference key) const {
+            return std::upper_bound(begin(), end(), key, [](first_const_reference k, pair_template_const_reference entry) {
+                return k < entry.first;
+            });
+        }
+
+        // Returns [lower_bound(key), upper_bound(key)), which holds at most one pair
+        [[maybe_unused]] mc::pair<const pair_template*, const pair_template*> equal_range(first_const_reference key) const {
+            const pair_template* lower = lower_bound(key);
+
+            if (lower != end() and not (key < lower->first)) {
+                return {lower, lower + 1};
+            }
+
+            return {lower, lower};
+        }
+
+        // Returns a pointer to the pair with this key, or end() if the key is not in the map
+        [[maybe_unused]] pair_template_pointer find(first_const_reference key) {
+            return m_vector.begin() + (static_cast<const flat_map&>(*this).find(key) - begin());
+        }
+
+        [[maybe_unused]] const pair_template* find(first_const_reference key) const {
+            const pair_template* lower = lower_bound(key);
+            return lower != end() and not (key < lower->first) ? lower : end();
+        }
+
+        [[maybe_unused]] [[nodiscard]] bool contains(first_const_reference key) const {
+            return find(key) != end();
+        }
+
+        // Adds the pair only if its key is not in the map yet.
+        // Returns a pointer to the pair with this key and whether it was inserted
+        [[maybe_unused]] mc::pair<pair_template_pointer, bool> insert(pair_template entry) {
+            std::size_t index = lower_index(entry.first);
+
+            if (index != size() and not (entry.first < m_vector[index].first)) {
+                return {m_vector.begin() + index, false};
+            }
+
+            return {&m_vector.insert(index, std::move(entry)), true};
+        }
+
+        [[maybe_unused]] mc::pair<pair_template_pointer, bool> insert(first_type first, second_type second) {
+            return insert(pair_template(std::move(first), std::move(second)));
+        }
+
+        // Adds the pair if the key is not in the map yet, overwrites the value of the existing pair otherwise
+        [[maybe_unused]] mc::pair<pair_template_pointer, bool> insert_or_assign(first_type key, second_type value) {
+            std::size_t index = lower_index(key);
+
+            if (index != size() and not (key < m_vector[index].first)) {
+                m_vector[index].second = std::move(value);
+                return {m_vector.begin() + index, false};
+            }
+
+            return {&m_vector.emplace(index, std::move(key), std::move(value)), true};
+        }
+
+        // Adds all pairs in [first, last) at once: they are appended, sorted among themselves and merged with the
+        // pairs that are already there. That is O(n + m log m) instead of O(n * m) for one insert at a time.
+        // Like insert, a key that is already in the map keeps its value, and the first of duplicate new keys wins
+        template <typename InputIterator> requires std::input_iterator<InputIterator>
+        [[maybe_unused]] void insert(InputIterator first, InputIterator last) {
+            const std::size_t old_size = size();
+
+            // A copy or an allocation that throws halfway would leave unsorted pairs behind, so those go again
+            try {
+                for (; first != last; ++first) {
+                    m_vector.push_back(*first);
+                }
+            } catch (...) {
+                while (size() != old_size) {
+                    m_vector.pop_back();
+                }
+
+                throw;
+            }
+
+            // Both sorts are stable, so equal keys stay in the order old pairs first, then new pairs in input order
+            mc::sorting::sort_by_key(m_vector.begin() + old_size, m_vector.end());
+
+            auto key_less = [](pair_template_const_reference a, pair_template_const_reference b) {
+                return a.first < b.first;
+            };
+            std::inplace_merge(m_vector.begin(), m_vector.begin() + old_size, m_vector.end(), key_less);
+
+            // Keep the first pair of every key
+            pair_template* unique_end = std::unique(m_vector.begin(), m_vector.end(), [](pair_template_const_reference a, pair_template_const_reference b) {
+                return not (a.first < b.first) and not (b.first < a.first);
+            });
+
+            while (m_vector.end() != unique_end) {
+                m_vector.pop_back();
+            }
+        }
+
+        // Removes the pair with this key and returns how many pairs were removed (0 or 1)
+        [[maybe_unused]] std::size_t erase_key(first_const_reference key) {
+            const pair_template* found = find(key);
+
+            if (found == end()) {
+                return 0;
+            }
+
+            m_vector.erase(static_cast<std::size_t>(found - begin()));
+            return 1;
+        }
+
+        [[maybe_unused]] void erase(std::size_t index) {
+            m_vector.erase(index);
+        }
+
+        [[maybe_unused]] void erase() {
+            m_vector.erase();
+        }
+
+        [[maybe_unused]] pair_template_const_reference at(std::size_t index) const {
+            return m_vector.at(index);
+        }
+
+        // Positional access is read-only, changing a key could break the order
+        [[maybe_unused]] pair_template_const_reference operator[](std::size_t index) const {
+            return m_vector[index];
+        }
+
+        // Debug print function
+        [[maybe_unused]] void debug_print(std::ostream& stream = std::cout) {
+            m_vector.debug_print(stream);
+        }
+
+        const pair_template* begin() const {
+            return m_vector.begin();
+        }
+
+        const pair_template* end() const {
+            return m_vector.end();
+        }
+
+    private:
+        [[nodiscard]] std::size_t lower_index(first_const_reference key) const {
+            return static_cast<std::size_t>(lower_bound(key) - begin());
+        }
+
+        vector_template m_vector;
+    };
+
+    // Out stream operator for flat_map
+    template<typename TKey, typename TValue, typename Allocator>
+    std::ostream& operator<<(std::ostream& stream, const flat_map<TKey, TValue, Allocator>& other) {
+        stream << "mc::flat_map{";
+
+        for (std::size_t i = 0; i < other.size(); i++) {
+            stream << "(" << other[i].first << ", " << other[i].second << ")";
+            // Add ', ' between every element except the last
+            if (i != other.size() - 1)
+                stream << ", ";
+        }
+
+        stream << "}";
+
+        return stream;
+    }
+
+    // Both maps are sorted, so equal maps have their pairs in the same order
+    template<typename TKey, typename TValue, typename Allocator>
+    bool operator==(const flat_map<TKey, TValue, Allocator>& a, const flat_map<TKey, TValue, Allocator>& b) {
+        return a.size() == b.size() and std::equal(a.begin(), a.end(), b.begin());
+    }
+
+}
+
+#endif //APC_LIBRARY_FLAT_MAP_H
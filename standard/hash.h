@@ -0,0 +1,45 @@
+//
+// Created by Camiel Verdult on 17/10/2026.
+//
+
+#ifndef APC_LIBRARY_HASH_H
+#define APC_LIBRARY_HASH_H
+
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace mc {
+
+    // The hash the hashed containers (mc::map, mc::soa_map, mc::concurrent_map) use for their keys.
+    // By default this is just std::hash. A specialisation with an is_transparent member can also hash other types
+    // than the key, as long as they hash to the same value as an equal key. Then find/contains/erase_key take those
+    // types directly and no temporary key is built, like std::unordered_map with a transparent hash
+    template<typename T>
+    struct hash : std::hash<T> {};
+
+    // Strings hash through std::basic_string_view, which std::hash guarantees gives the same value as the string.
+    // So a map with std::string keys can be searched with a std::string_view or a const char* without copying it
+    template<typename CharT, typename Traits, typename Allocator>
+    struct hash<std::basic_string<CharT, Traits, Allocator>> {
+        using is_transparent = void;
+
+        std::size_t operator()(std::basic_string_view<CharT, Traits> key) const noexcept {
+            return std::hash<std::basic_string_view<CharT, Traits>>{}(key);
+        }
+    };
+
+    // Key can be used to look up a TKey: it is TKey itself, or mc::hash<TKey> is transparent and can hash Key,
+    // and Key can be compared with TKey
+    template<typename Key, typename TKey>
+    concept lookup_key = std::same_as<Key, TKey> or (
+        requires { typename hash<TKey>::is_transparent; } and
+        requires(const TKey& stored, const Key& key) {
+            { hash<TKey>{}(key) } -> std::convertible_to<std::size_t>;
+            { stored == key } -> std::convertible_to<bool>;
+        });
+}
+
+#endif //APC_LIBRARY_HASH_H
@@ -0,0 +1,472 @@
+//
+// Created by Camiel Verdult on 17/10/2026.
+//
+
+#ifndef APC_LIBRARY_HASH_INDEX_H
+#define APC_LIBRARY_HASH_INDEX_H
+
+#include "hash.h"
+#include "simd.h"
+#include "vector.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+
+namespace mc::detail {
+
+    // An open-addressing hash index in the style of a Swiss table that maps a key to a position in some contiguous
+    // storage. The index does not own the keys, every function that needs them gets key_at, a callable that returns
+    // the key at a position. That way mc::map (keys inside pairs) and mc::soa_map (keys in their own column)
+    // share one index, and the pairs themselves stay contiguous.
+    //
+    // Every slot has a control byte: EMPTY, or the 7 bit fragment H2 of the hash of the key in that slot.
+    // A lookup loads the 16 control bytes from the home slot onwards with one SSE2 load and compares all of them with
+    // the H2 of the key at once, only the slots that match have their key compared. Mostly that is one slot, so
+    // a lookup costs one cache line of control bytes, one position and the pair itself.
+    //
+    // Probing is linear, so deleting shifts the entries after the gap back instead of leaving a tombstone.
+    // Lookups never have to skip deleted slots, which keeps them fast even at a load factor of 7/8.
+    // Growing can rebuild everything at once (the default) or spread the work over the next inserts, see set_incremental
+    template<typename TKey, typename Allocator = std::allocator<std::size_t>>
+    class hash_index {
+    public:
+        static constexpr std::size_t NOT_FOUND{static_cast<std::size_t>(-1)};
+        static constexpr std::size_t GROUP{16};
+        static constexpr std::size_t MIN_SLOTS{GROUP};
+
+        // How many positions every insert moves from the old table to the new one while growing incrementally
+        static constexpr std::size_t MIGRATE_STEP{16};
+
+        // How many slots of the next table every insert initializes once the table is 13/16 full.
+        // That is 1/16 of the slots later than growing at 7/8, enough to initialize a twice as big table twice over
+        static constexpr std::size_t INIT_STEP{64};
+
+        explicit hash_index(const Allocator& allocator = Allocator()) :
+            m_table (allocator),
+            m_old (allocator),
+            m_next (allocator) {}
+
+        // Normally growing rebuilds the whole index at once, which is the fastest in total but makes that one insert
+        // take O(n). With incremental growth nothing is done all at once: the next, twice as big table is allocated
+        // ahead of time and initialized INIT_STEP slots per insert, then the old table is kept next to it and every
+        // insert moves MIGRATE_STEP positions over. Lookups check the new table first and the old one after that,
+        // until everything is moved
+        void set_incremental(bool enabled) noexcept {
+            m_incremental = enabled;
+        }
+
+        [[nodiscard]] bool incremental() const noexcept {
+            return m_incremental;
+        }
+
+        // Whether an incremental growth is still moving positions to the new table
+        [[nodiscard]] bool migrating() const noexcept {
+            return m_old.slot_count() != 0;
+        }
+
+        // Returns the position of key, or NOT_FOUND. Key can be any type mc::hash<TKey> can hash transparently
+        template<typename Key, typename KeyAt>
+        [[nodiscard]] std::size_t find(const Key& key, KeyAt&& key_at) const {
+            std::size_t slot = m_table.find_slot(key, key_at, NOT_FOUND);
+
+            if (slot != NOT_FOUND) {
+                return m_table.positions[slot];
+            }
+
+            if (migrating()) {
+                // Positions from m_old_limit onwards were removed or reused since growing began, skip those
+                slot = m_old.find_slot(key, key_at, m_old_limit);
+
+                if (slot != NOT_FOUND) {
+                    return m_old.positions[slot];
+                }
+            }
+
+            return NOT_FOUND;
+        }
+
+        // Adds position, which has to be the last of count positions (i.e. it was just pushed back)
+        template<typename KeyAt>
+        void insert(std::size_t position, std::size_t count, KeyAt&& key_at) {
+            // Keep the load factor at or below 7/8, the SIMD probing keeps the longer runs cheap
+            if (count * 8 > m_table.slot_count() * 7) {
+                if (not m_incremental or m_table.slot_count() == 0) {
+                    rebuild(count, key_at, m_table.slot_count() * 2);
+                    return;
+                }
+
+                grow(position, key_at);
+            } else {
+                m_table.place(position, key_at(position));
+
+                if (m_incremental and count * 16 > m_table.slot_count() * 13) {
+                    prepare(INIT_STEP);
+                }
+            }
+
+            migrate(MIGRATE_STEP, key_at);
+        }
+
+        // Removes position from the index, it has to be the last position (i.e. it is about to be popped)
+        template<typename KeyAt>
+        void erase(std::size_t position, KeyAt&& key_at) {
+            std::size_t slot = m_table.slot_of(position, key_at);
+
+            // While migrating the position might only be in the old table
+            if (slot != NOT_FOUND) {
+                m_table.remove_slot(slot, key_at);
+            }
+
+            m_old_limit = std::min(m_old_limit, position);
+        }
+
+        // Removes position and points the entry of last at position instead, for a swap-and-pop erase.
+        // Call this before last is moved into position, both keys are still needed
+        template<typename KeyAt>
+        void erase_swap(std::size_t position, std::size_t last, KeyAt&& key_at) {
+            std::size_t slot = m_table.slot_of(position, key_at);
+
+            if (slot != NOT_FOUND) {
+                m_table.remove_slot(slot, key_at);
+            }
+
+            if (position != last) {
+                slot = m_table.slot_of(last, key_at);
+
+                if (slot != NOT_FOUND) {
+                    m_table.positions[slot] = position;
+                } else {
+                    // Last was not migrated yet, it moves straight into the new table under its new position
+                    m_table.place(position, key_at(last));
+                }
+            }
+
+            m_old_limit = std::min(m_old_limit, last);
+        }
+
+        // Rebuilds the index for positions [0, count), with at least slot_count slots
+        template<typename KeyAt>
+        void rebuild(std::size_t count, KeyAt&& key_at, std::size_t slot_count) {
+            std::size_t slots = MIN_SLOTS;
+
+            // Round up to a power of two so we can wrap around with a mask
+            while (slots < slot_count) {
+                slots *= 2;
+            }
+
+            m_table = table(slots, m_table.positions.get_allocator());
+            m_table.fill(slots);
+            stop_migrating();
+
+            // A table prepared for the old size is no use anymore
+            m_next = table(m_table.positions.get_allocator());
+
+            for (std::size_t position = 0; position < count; position++) {
+                m_table.place(position, key_at(position));
+            }
+        }
+
+        // Makes room for count positions, so inserting up to that many does not grow (or migrate) at all
+        template<typename KeyAt>
+        void reserve(std::size_t count, std::size_t current, KeyAt&& key_at) {
+            if (count * 8 > m_table.slot_count() * 7) {
+                rebuild(current, key_at, count + count / 7 + 1);
+            }
+        }
+
+        // Empties all slots but keeps them allocated
+        void clear() {
+            m_table.clear();
+            stop_migrating();
+        }
+
+    private:
+        using control_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<std::uint8_t>;
+        using control_template = mc::vector<std::uint8_t, growth::doubling, control_allocator>;
+        using positions_template = mc::vector<std::size_t, growth::doubling, Allocator>;
+
+        // Full slots hold H2, which is below 0x80, so the high bit alone tells empty from full
+        static constexpr std::uint8_t EMPTY{0x80};
+
+        // Bit i of match is set when control byte i of the group equals the H2 of the key,
+        // bit i of empty when slot i is empty
+        struct group_masks {
+            std::uint32_t match;
+            std::uint32_t empty;
+        };
+
+        static group_masks scan_group(const std::uint8_t* control, std::uint8_t h2) noexcept {
+#if MC_SIMD_X86
+            __m128i group = _mm_loadu_si128(reinterpret_cast<const __m128i*>(control));
+            __m128i needle = _mm_set1_epi8(static_cast<char>(h2));
+
+            return {static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(group, needle))),
+                    static_cast<std::uint32_t>(_mm_movemask_epi8(group))};
+#else
+            group_masks masks{0, 0};
+
+            for (std::size_t i = 0; i < GROUP; i++) {
+                masks.match |= static_cast<std::uint32_t>(control[i] == h2) << i;
+                masks.empty |= static_cast<std::uint32_t>(control[i] == EMPTY) << i;
+            }
+
+            return masks;
+#endif
+        }
+
+        // std::hash is the identity for integers on libstdc++, so we spread the bits with a Fibonacci multiply.
+        // The top bits pick the home slot (H1), the 7 bits right below them are the fragment in the control byte (H2)
+        template<typename Key>
+        static std::uint64_t mix(const Key& key) {
+            return static_cast<std::uint64_t>(mc::hash<TKey>{}(key)) * 11400714819323198485ull;
+        }
+
+        // One set of slots, while growing incrementally there are two of these
+        struct table {
+            control_template control;
+            positions_template positions;
+            std::size_t slot_shift{64};
+
+            explicit table(const Allocator& allocator) :
+                control (0, control_allocator(allocator)),
+                positions (0, allocator) {}
+
+            // Allocates room for slots, which has to be a power of two, but does not initialize them.
+            // The table can only be used once fill() has initialized all of them
+            table(std::size_t slots, const Allocator& allocator) :
+                control (slots + GROUP - 1, control_allocator(allocator)),
+                positions (slots, allocator),
+                slot_shift {64 - static_cast<std::size_t>(std::countr_zero(slots))} {}
+
+            table(const table& other) = default;
+            table& operator=(const table& other) = default;
+
+            // Takes over the slots of other and leaves it empty
+            table(table&& other) noexcept :
+                control {std::move(other.control)},
+                positions {std::move(other.positions)},
+                slot_shift {std::exchange(other.slot_shift, 64)} {}
+
+            table& operator=(table&& other) noexcept(std::is_nothrow_move_assignable_v<positions_template>
+                                                     and std::is_nothrow_move_assignable_v<control_template>) {
+                if (this != &other) {
+                    control = std::move(other.control);
+                    positions = std::move(other.positions);
+                    slot_shift = std::exchange(other.slot_shift, 64);
+                }
+
+                return *this;
+            }
+
+            [[nodiscard]] std::size_t slot_count() const noexcept {
+                return positions.size();
+            }
+
+            // Initializes up to step more slots, returns whether all slots are initialized now
+            bool fill(std::size_t step) {
+                std::size_t slots = std::size_t{1} << (64 - slot_shift);
+                std::size_t target = slots - positions.size() <= step ? slots : positions.size() + step;
+
+                positions.resize(target, 0);
+
+                // GROUP - 1 extra control bytes mirror the first ones, so a group load near the end wraps around
+                control.resize(target == slots ? slots + GROUP - 1 : target, EMPTY);
+                return target == slots;
+            }
+
+            [[nodiscard]] std::size_t slot_mask() const noexcept {
+                return slot_count() - 1;
+            }
+
+            [[nodiscard]] std::size_t home_slot(std::uint64_t mixed) const noexcept {
+                return static_cast<std::size_t>(mixed >> slot_shift);
+            }
+
+            [[nodiscard]] std::uint8_t fragment(std::uint64_t mixed) const noexcept {
+                return static_cast<std::uint8_t>((mixed >> (slot_shift - 7)) & 0x7F);
+            }
+
+            void set_control(std::size_t slot, std::uint8_t value) {
+                control[slot] = value;
+
+                // Keep the mirrored bytes after the end in sync
+                if (slot < GROUP - 1) {
+                    control[slot_count() + slot] = value;
+                }
+            }
+
+            void clear() {
+                std::fill(control.begin(), control.end(), EMPTY);
+            }
+
+            // Returns the slot holding the position of key, or NOT_FOUND. Positions from limit onwards are skipped
+            template<typename Key, typename KeyAt>
+            std::size_t find_slot(const Key& key, KeyAt& key_at, std::size_t limit) const {
+                if (slot_count() == 0) {
+                    return NOT_FOUND;
+                }
+
+                std::uint64_t mixed = mix(key);
+                std::uint8_t h2 = fragment(mixed);
+
+                // The probe sequence ends at the first empty slot, the table is never full so this always terminates
+                for (std::size_t slot = home_slot(mixed); ; slot = (slot + GROUP) & slot_mask()) {
+                    group_masks masks = scan_group(control.begin() + slot, h2);
+
+                    // Matches after the first empty slot belong to other probe sequences
+                    std::uint32_t candidates = masks.match;
+                    if (masks.empty != 0) {
+                        candidates &= (std::uint32_t{1} << std::countr_zero(masks.empty)) - 1;
+                    }
+
+                    while (candidates != 0) {
+                        std::size_t candidate = (slot + static_cast<std::size_t>(std::countr_zero(candidates))) & slot_mask();
+
+                        if (positions[candidate] < limit and key_at(positions[candidate]) == key) {
+                            return candidate;
+                        }
+
+                        candidates &= candidates - 1;
+                    }
+
+                    if (masks.empty != 0) {
+                        return NOT_FOUND;
+                    }
+                }
+            }
+
+            // Returns the slot holding exactly this position, or NOT_FOUND
+            template<typename KeyAt>
+            std::size_t slot_of(std::size_t position, KeyAt& key_at) const {
+                if (slot_count() == 0) {
+                    return NOT_FOUND;
+                }
+
+                for (std::size_t slot = home_slot(mix(key_at(position))); control[slot] != EMPTY; slot = (slot + 1) & slot_mask()) {
+                    if (positions[slot] == position) {
+                        return slot;
+                    }
+                }
+
+                return NOT_FOUND;
+            }
+
+            // Stores position in the first empty slot of the probe sequence of key
+            void place(std::size_t position, const TKey& key) {
+                std::uint64_t mixed = mix(key);
+
+                // Find the first empty slot from home onwards, 16 slots at a time
+                for (std::size_t slot = home_slot(mixed); ; slot = (slot + GROUP) & slot_mask()) {
+                    std::uint32_t empty = scan_group(control.begin() + slot, EMPTY).empty;
+
+                    if (empty != 0) {
+                        std::size_t target = (slot + static_cast<std::size_t>(std::countr_zero(empty))) & slot_mask();
+
+                        set_control(target, fragment(mixed));
+                        positions[target] = position;
+                        return;
+                    }
+                }
+            }
+
+            // Backward shift deletion: instead of leaving a tombstone we move later entries of the same
+            // probe sequence back into the gap, so lookups never have to skip over deleted slots
+            template<typename KeyAt>
+            void remove_slot(std::size_t gap, KeyAt& key_at) {
+                std::size_t slot = gap;
+
+                while (true) {
+                    slot = (slot + 1) & slot_mask();
+
+                    if (control[slot] == EMPTY) {
+                        break;
+                    }
+
+                    // Distance from the home slot, an entry may only move back if the gap is not before its home
+                    std::size_t home = home_slot(mix(key_at(positions[slot])));
+                    if (((slot - home) & slot_mask()) >= ((slot - gap) & slot_mask())) {
+                        set_control(gap, control[slot]);
+                        positions[gap] = positions[slot];
+                        gap = slot;
+                    }
+                }
+
+                set_control(gap, EMPTY);
+            }
+        };
+
+        // Allocates the next, twice as big table if that did not happen yet and initializes up to step of its slots
+        void prepare(std::size_t step) {
+            if (m_next.positions.capacity() == 0) {
+                m_next = table(m_table.slot_count() * 2, m_table.positions.get_allocator());
+            }
+
+            m_next.fill(step);
+        }
+
+        // Keeps the full table as the old one and switches to the prepared one, position goes straight into the new one
+        template<typename KeyAt>
+        void grow(std::size_t position, KeyAt& key_at) {
+            // The previous growth should be done long before the table is full again, finish it just in case
+            migrate(NOT_FOUND, key_at);
+
+            // Likewise the inserts since 13/16 should have initialized the next table already
+            prepare(NOT_FOUND);
+
+            m_old = std::move(m_table);
+            m_table = std::move(m_next);
+            m_next = table(m_old.positions.get_allocator());
+
+            // Positions [0, position) are in the old table and still have to be moved
+            m_cursor = 0;
+            m_old_limit = position;
+
+            m_table.place(position, key_at(position));
+        }
+
+        // Moves up to steps positions from the old table to the new one, and frees the old table once it is done
+        template<typename KeyAt>
+        void migrate(std::size_t steps, KeyAt& key_at) {
+            if (not migrating()) {
+                return;
+            }
+
+            for (; steps > 0 and m_cursor < m_old_limit; steps--, m_cursor++) {
+                // An erase_swap can already have put this position in the new table
+                if (m_table.slot_of(m_cursor, key_at) == NOT_FOUND) {
+                    m_table.place(m_cursor, key_at(m_cursor));
+                }
+            }
+
+            if (m_cursor >= m_old_limit) {
+                stop_migrating();
+            }
+        }
+
+        void stop_migrating() {
+            m_old = table(m_old.positions.get_allocator());
+            m_cursor = 0;
+            m_old_limit = 0;
+        }
+
+        table m_table;
+
+        // Only used while growing incrementally: positions [m_cursor, m_old_limit) are still only in m_old
+        table m_old;
+
+        // Only used while growing incrementally: the table m_table grows into next, being initialized bit by bit
+        table m_next;
+        std::size_t m_cursor{0};
+        std::size_t m_old_limit{0};
+
+        bool m_incremental{false};
+    };
+
+}
+
+#endif //APC_LIBRARY_HASH_INDEX_H
@@ -0,0 +1,265 @@
+//
+// Created by Camiel Verdult on 17/10/2026.
+//
+
+#ifndef APC_LIBRARY_INSTRUMENTATION_H
+#define APC_LIBRARY_INSTRUMENTATION_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <typeinfo>
+#include <vector>
+
+#if defined(__GNUC__) or defined(__clang__)
+#include <cxxabi.h>
+#endif
+
+// Build with MC_INSTRUMENTATION=1 (the CMake option of the same name) to count what the mc containers do with their
+// memory, per container type: allocations, bytes, reallocations and the elements they moved, element copies, the
+// largest capacity ever reached and the capacity that was never used when a buffer was freed ("slack").
+// This shows how often growth happens and whether DEFAULT_CAP or a reserve() up front would pay off.
+//
+// Without it every hook is an empty if constexpr, so there is no code and no data at all.
+// Set it for the whole program, mixing instrumented and plain translation units breaks the one definition rule.
+//
+// Counted as themselves: mc::vector, mc::small_vector (only its heap buffer), mc::concurrent_vector (its segments),
+// mc::btree_map (its nodes) and mc::mmap_vector (its mapping, growing the file counts as a reallocation).
+// Everything built on mc::vector (mc::map, mc::flat_map, mc::soa_vector, ...) is counted as its mc::vector type.
+// Copies are every element built from an existing one: copy constructors and assignments, push_back/insert of an
+// lvalue, resize with a value
+#ifndef MC_INSTRUMENTATION
+#define MC_INSTRUMENTATION 0
+#endif
+
+namespace mc::instrumentation {
+
+    inline constexpr bool ENABLED{MC_INSTRUMENTATION != 0};
+
+    enum class event_kind {
+        allocate,    // a new buffer, bytes and capacity are set
+        deallocate,  // a buffer was freed, bytes is set
+        reallocate,  // growth moved the elements to a bigger buffer, capacity is the new one and elements were moved
+        copy,        // elements were copy-constructed, e.g. by a copy constructor or copy assignment
+        release      // a vector was destroyed with capacity room of which elements were used
+    };
+
+    // What the hook gets to see, container is the readable name of the container type
+    struct event {
+        event_kind kind;
+        const char* container;
+        std::size_t bytes;
+        std::size_t capacity;
+        std::size_t elements;
+    };
+
+    // The running totals of one container type, updated from any thread
+    struct counters {
+        std::atomic<std::uint64_t> allocations{0};
+        std::atomic<std::uint64_t> deallocations{0};
+        std::atomic<std::uint64_t> bytes_allocated{0};
+        std::atomic<std::uint64_t> bytes_deallocated{0};
+        std::atomic<std::uint64_t> reallocations{0};
+        std::atomic<std::uint64_t> elements_moved{0};
+        std::atomic<std::uint64_t> elements_copied{0};
+        std::atomic<std::uint64_t> peak_capacity{0};
+        std::atomic<std::uint64_t> slack_bytes{0};
+    };
+
+    // A plain copy of counters at one moment, with the container it belongs to
+    struct report {
+        std::string container;
+        std::uint64_t allocations;
+        std::uint64_t deallocations;
+        std::uint64_t bytes_allocated;
+        std::uint64_t bytes_deallocated;
+        std::uint64_t reallocations;
+        std::uint64_t elements_moved;
+        std::uint64_t elements_copied;
+        std::uint64_t peak_capacity;
+        std::uint64_t slack_bytes;
+    };
+
+    // Called for every event, e.g. to log it or to capture a stack trace of the code that made a vector grow.
+    // It runs on the thread that caused the event, must not throw and must not use instrumented containers itself
+    using hook_type = void (*)(const event&);
+
+    namespace detail {
+        inline std::string readable_name(const char* mangled) {
+#if defined(__GNUC__) or defined(__clang__)
+            int status = 0;
+            char* demangled = abi::__cxa_demangle(mangled, nullptr, nullptr, &status);
+
+            if (status == 0 and demangled != nullptr) {
+                std::string name{demangled};
+                std::free(demangled);
+                return name;
+            }
+#endif
+            return mangled;
+        }
+
+        struct entry {
+            std::string name;
+            counters* totals;
+        };
+
+        // Every container type that had an event, this uses std::vector so it does not count itself
+        struct registry {
+            std::mutex lock;
+            std::vector<entry> entries;
+            std::atomic<hook_type> hook{nullptr};
+        };
+
+        inline registry& global() {
+            static registry instance;
+            return instance;
+        }
+
+        // Registers itself on first use, after that finding the counters of a type is free
+        template <typename Container>
+        struct type_entry {
+            counters totals;
+            std::string name{readable_name(typeid(Container).name())};
+
+            type_entry() {
+                std::lock_guard guard{global().lock};
+                global().entries.push_back({name, &totals});
+            }
+        };
+
+        template <typename Container>
+        type_entry<Container>& entry_of() {
+            static type_entry<Container> instance;
+            return instance;
+        }
+
+        inline void raise_to(std::atomic<std::uint64_t>& peak, std::uint64_t value) {
+            std::uint64_t current = peak.load(std::memory_order_relaxed);
+
+            while (current < value and not peak.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+        }
+    }
+
+    // The counters of one container type, e.g. counters_of<mc::vector<int>>()
+    template <typename Container>
+    counters& counters_of() {
+        return detail::entry_of<Container>().totals;
+    }
+
+    // Called by the containers, this is where the counting happens
+    template <typename Container>
+    void record(event_kind kind, std::size_t bytes, std::size_t capacity, std::size_t elements) {
+        if constexpr (ENABLED) {
+            auto& entry = detail::entry_of<Container>();
+            auto& totals = entry.totals;
+            constexpr auto relaxed = std::memory_order_relaxed;
+
+            switch (kind) {
+                case event_kind::allocate:
+                    totals.allocations.fetch_add(1, relaxed);
+                    totals.bytes_allocated.fetch_add(bytes, relaxed);
+                    detail::raise_to(totals.peak_capacity, capacity);
+                    break;
+                case event_kind::deallocate:
+                    totals.deallocations.fetch_add(1, relaxed);
+                    totals.bytes_deallocated.fetch_add(bytes, relaxed);
+                    break;
+                case event_kind::reallocate:
+                    totals.reallocations.fetch_add(1, relaxed);
+                    totals.elements_moved.fetch_add(elements, relaxed);
+                    break;
+                case event_kind::copy:
+                    totals.elements_copied.fetch_add(elements, relaxed);
+                    break;
+                case event_kind::release:
+                    totals.slack_bytes.fetch_add(bytes, relaxed);
+                    break;
+            }
+
+            if (hook_type hook = detail::global().hook.load(std::memory_order_acquire)) {
+                hook(event{kind, entry.name.c_str(), bytes, capacity, elements});
+            }
+        }
+    }
+
+    // True when building a T from Args copies an existing T, e.g. push_back(const T&) or emplace_back(lvalue)
+    template <typename T, typename... Args>
+    inline constexpr bool copies_v = sizeof...(Args) == 1 and
+        ((std::is_same_v<std::remove_cvref_t<Args>, T> and
+          (std::is_lvalue_reference_v<Args> or std::is_const_v<std::remove_reference_t<Args>>)) and ...);
+
+    // Called by the containers before they build an element from args, counts it if that is a copy
+    template <typename Container, typename T, typename... Args>
+    void record_construct() {
+        if constexpr (copies_v<T, Args...>) {
+            record<Container>(event_kind::copy, sizeof(T), 0, 1);
+        }
+    }
+
+    // Installs the hook that is called for every event, nullptr removes it. Returns the previous hook
+    inline hook_type set_hook(hook_type hook) {
+        return detail::global().hook.exchange(hook, std::memory_order_acq_rel);
+    }
+
+    // The totals of every container type that had at least one event
+    inline std::vector<report> reports() {
+        auto& registry = detail::global();
+        std::lock_guard guard{registry.lock};
+
+        std::vector<report> result;
+        result.reserve(registry.entries.size());
+
+        for (const auto& entry : registry.entries) {
+            const counters& totals = *entry.totals;
+
+            result.push_back({entry.name,
+                              totals.allocations.load(), totals.deallocations.load(),
+                              totals.bytes_allocated.load(), totals.bytes_deallocated.load(),
+                              totals.reallocations.load(), totals.elements_moved.load(),
+                              totals.elements_copied.load(), totals.peak_capacity.load(),
+                              totals.slack_bytes.load()});
+        }
+
+        return result;
+    }
+
+    // Sets all counters back to 0, e.g. between the phases of a benchmark
+    inline void reset() {
+        auto& registry = detail::global();
+        std::lock_guard guard{registry.lock};
+
+        for (auto& entry : registry.entries) {
+            counters& totals = *entry.totals;
+
+            for (auto* counter : {&totals.allocations, &totals.deallocations, &totals.bytes_allocated,
+                                  &totals.bytes_deallocated, &totals.reallocations, &totals.elements_moved,
+                                  &totals.elements_copied, &totals.peak_capacity, &totals.slack_bytes}) {
+                counter->store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Prints one line per container type
+    inline std::ostream& print(std::ostream& stream) {
+        for (const auto& line : reports()) {
+            stream << line.container
+                   << ": allocations=" << line.allocations
+                   << " bytes=" << line.bytes_allocated
+                   << " reallocations=" << line.reallocations
+                   << " moved=" << line.elements_moved
+                   << " copied=" << line.elements_copied
+                   << " peak_capacity=" << line.peak_capacity
+                   << " slack_bytes=" << line.slack_bytes << "\n";
+        }
+
+        return stream;
+    }
+}
+
+#endif //APC_LIBRARY_INSTRUMENTATION_H
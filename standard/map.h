@@ -5,15 +5,34 @@
 #ifndef APC_LIBRARY_MAP_H
 #define APC_LIBRARY_MAP_H
 
+#include "hash.h"
+#include "hash_index.h"
 #include "pair.h"
 #include "vector.h"
+#include <cstdint>
+#include <functional>
 #include <initializer_list>
+#include <memory>
+#include <memory_resource>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <utility>
 
 
 namespace mc {
 
-    template<typename TKey, typename TValue>
+    // The pairs and the hash index both get their memory from Allocator, see mc::pmr::map for a std::pmr version
+    template<typename TKey, typename TValue, typename Allocator = std::allocator<mc::pair<TKey, TValue>>>
     class map { // This whole class is a wrapper around an mc::vector<mc::pair>
+        // The pairs themselves stay in m_vector in insertion order, so the positional functions keep working.
+        // On top of that we keep a Swiss table style hash index that maps a key to its position in m_vector
+        // (see hash_index.h), this gives us expected O(1) find/contains/try_emplace/insert_or_assign/erase(key).
+        //
+        // Functions that move pairs around by position (insert(i), erase(i), sort, ...) do not update the index,
+        // they mark it as stale and it is rebuilt once on the next key lookup.
+        // operator[], at, begin/end and raw hand out the pairs themselves without touching the index, so reading
+        // through them stays cheap. Whoever changes a key or moves pairs around through them has to call reindex().
     public:
 
         using first_type = TKey;
@@ -31,16 +50,26 @@ namespace mc {
         using pair_template_reference = pair_template&;
         using pair_template_const_reference = const pair_template&;
 
-        using vector_template = mc::vector<pair_template>;
+        using allocator_type = Allocator;
+
+        using vector_template = mc::vector<pair_template, growth::doubling, Allocator>;
         using vector_template_pointer = vector_template*;
         using vector_template_reference = vector_template&;
         using vector_template_const_reference = const vector_template&;
 
+        // The iterators are pointers into the underlying vector, so a map is a std::ranges::contiguous_range of pairs
+        using value_type = pair_template;
+        using iterator = pair_template*;
+        using const_iterator = const pair_template*;
+
         // Default constructor
-        explicit map() : m_vector {} {}
+        explicit map(const Allocator& allocator = Allocator()) :
+            m_vector (allocator),
+            m_index (slots_allocator(allocator)),
+            m_index_stale {false} {}
 
         // initializer list constructor
-        map(std::initializer_list<pair_template> list) : map() {
+        map(std::initializer_list<pair_template> list, const Allocator& allocator = Allocator()) : map(allocator) {
             for (auto& entry : list) {
                 push_back(entry);
             }
@@ -49,7 +78,16 @@ namespace mc {
         // Copy constructor, this will call vector's copy constructor
         // which will handle the rest
 
-        map(const map &other) : m_vector {other.raw()} {}
+        map(const map &other) :
+            m_vector {other.raw()},
+            m_index {other.m_index},
+            m_index_stale {other.m_index_stale} {}
+
+        // Move constructor, this takes over the buffers of other and leaves it empty
+        map(map&& other) noexcept :
+            m_vector {std::move(other.m_vector)},
+            m_index {std::move(other.m_index)},
+            m_index_stale {std::exchange(other.m_index_stale, false)} {}
 
 
         [[maybe_unused]] std::size_t capacity() {
@@ -72,8 +110,28 @@ namespace mc {
             return m_vector.size();
         }
 
+        // Makes room for count pairs, in the vector and in the index, so adding that many never has to grow
+        [[maybe_unused]] void reserve(std::size_t count) {
+            m_vector.reserve(count);
+            refresh_index();
+            m_index.reserve(count, m_vector.size(), key_at());
+        }
+
+        // With incremental rehashing the index grows by doing a little work on every insert instead of all at once,
+        // so no single insert pays O(n) for rehashing. That costs a little throughput, it is off by default.
+        // This only covers the index: the pairs live in one mc::vector and growing it still moves all of them in one
+        // insert. For a bounded worst case insert, reserve() the expected size up front as well
+        [[maybe_unused]] void incremental_rehash(bool enabled) noexcept {
+            m_index.set_incremental(enabled);
+        }
+
+        [[maybe_unused]] [[nodiscard]] allocator_type get_allocator() const {
+            return m_vector.get_allocator();
+        }
+
         vector_template_reference raw() {
             /* This function returns the underlying vector */
+            // Call reindex() after changing keys or the order of the pairs through this
             return m_vector;
         }
 
@@ -82,28 +140,128 @@ namespace mc {
             return m_vector;
         }
 
+        // A lazy view of the keys in the order of the pairs, nothing is copied.
+        // It composes with std::views, e.g. map.keys() | std::views::filter(...) | mc::to<mc::vector>()
+        [[maybe_unused]] auto keys() const {
+            return std::span<const pair_template>(m_vector.begin(), m_vector.size()) | std::views::transform(&pair_template::first);
+        }
+
+        // A lazy view of the values, they can be changed through it. The keys stay untouched, so the index stays valid
+        [[maybe_unused]] auto values() {
+            return std::span<pair_template>(m_vector.begin(), m_vector.size()) | std::views::transform(&pair_template::second);
+        }
+
+        [[maybe_unused]] auto values() const {
+            return std::span<const pair_template>(m_vector.begin(), m_vector.size()) | std::views::transform(&pair_template::second);
+        }
+
         // Push back function for manual mc::pair<T1, T2>
-        [[maybe_unused]] void push_back(const pair_template entry) {
-            m_vector.push_back(entry);
+        // Like before, this does not check for duplicate keys. Use try_emplace or insert_or_assign for that
+        [[maybe_unused]] void push_back(pair_template entry) {
+            m_vector.push_back(std::move(entry));
+            index_last();
         }
 
         // Push back function for pushing back values of template types
-        [[maybe_unused]] void push_back(const first_type first, const second_type second) {
-            m_vector.push_back(pair_template(first, second));
+        // The pair is constructed in place, the arguments are moved into it
+        [[maybe_unused]] void push_back(first_type first, second_type second) {
+            m_vector.emplace_back(std::move(first), std::move(second));
+            index_last();
         }
 
         // Insert function for manual mc::pair<T1, T2>
-        [[maybe_unused]] void insert(const std::size_t index, const pair_template entry) {
-            m_vector.insert(index, entry);
+        [[maybe_unused]] void insert(const std::size_t index, pair_template entry) {
+            m_vector.insert(index, std::move(entry));
+            m_index_stale = true; // Every pair after index has shifted one position
         }
 
         // Insert function for inserting values of template types
-        [[maybe_unused]] void insert(const std::size_t index, const first_type first, const second_type second) {
-            m_vector.insert(index, pair_template(first, second));
+        [[maybe_unused]] void insert(const std::size_t index, first_type first, second_type second) {
+            m_vector.emplace(index, std::move(first), std::move(second));
+            m_index_stale = true;
         }
 
         [[maybe_unused]] void pop_back() {
+            if (not m_index_stale) {
+                m_index.erase(m_vector.size() - 1, key_at());
+            }
+
+            m_vector.pop_back();
+        }
+
+        // Returns a pointer to the pair with this key, or end() if the key is not in the map.
+        // find/contains/erase_key also take other types than TKey when mc::hash<TKey> is transparent (see hash.h),
+        // e.g. a std::string_view or a const char* for std::string keys, without building a temporary key
+        template<typename Key = TKey> requires lookup_key<Key, TKey>
+        [[maybe_unused]] pair_template_pointer find(const Key& key) {
+            std::size_t position = find_position(key);
+            return position == NOT_FOUND ? m_vector.end() : m_vector.begin() + position;
+        }
+
+        template<typename Key = TKey> requires lookup_key<Key, TKey>
+        [[maybe_unused]] const pair_template* find(const Key& key) const {
+            std::size_t position = find_position(key);
+            return position == NOT_FOUND ? m_vector.end() : m_vector.begin() + position;
+        }
+
+        template<typename Key = TKey> requires lookup_key<Key, TKey>
+        [[maybe_unused]] [[nodiscard]] bool contains(const Key& key) const {
+            return find_position(key) != NOT_FOUND;
+        }
+
+        // Adds the pair only if the key is not in the map yet, the value is not touched otherwise.
+        // Returns a pointer to the pair with this key and whether it was inserted
+        // The value is only constructed from args when the key is inserted
+        template <typename... Args>
+        [[maybe_unused]] mc::pair<pair_template_pointer, bool> try_emplace(first_const_reference key, Args&&... args) {
+            std::size_t position = find_position(key);
+
+            if (position != NOT_FOUND) {
+                return {m_vector.begin() + position, false};
+            }
+
+            m_vector.emplace_back(key, second_type(std::forward<Args>(args)...));
+            index_last();
+            return {m_vector.end() - 1, true};
+        }
+
+        // Adds the pair if the key is not in the map yet, overwrites the value of the existing pair otherwise.
+        // Returns a pointer to the pair with this key and whether it was inserted
+        [[maybe_unused]] mc::pair<pair_template_pointer, bool> insert_or_assign(first_const_reference key, second_type value) {
+            std::size_t position = find_position(key);
+
+            if (position != NOT_FOUND) {
+                pair_template_pointer found = m_vector.begin() + position;
+                found->second = std::move(value);
+                return {found, false};
+            }
+
+            m_vector.emplace_back(key, std::move(value));
+            index_last();
+            return {m_vector.end() - 1, true};
+        }
+
+        // Removes the pair with this key and returns how many pairs were removed (0 or 1).
+        // To stay O(1) the last pair is moved into the gap, so this does not keep the order of the pairs
+        template<typename Key = TKey> requires lookup_key<Key, TKey>
+        [[maybe_unused]] std::size_t erase_key(const Key& key) {
+            std::size_t position = find_position(key);
+
+            if (position == NOT_FOUND) {
+                return 0;
+            }
+
+            std::size_t last = m_vector.size() - 1;
+
+            // Point the index entry of the last pair to the gap and move the pair over
+            m_index.erase_swap(position, last, key_at());
+
+            if (position != last) {
+                m_vector[position] = std::move(m_vector[last]);
+            }
+
             m_vector.pop_back();
+            return 1;
         }
 
         [[maybe_unused]] pair_template_reference at(std::size_t index) {
@@ -116,10 +274,19 @@ namespace mc {
 
         [[maybe_unused]] void erase() {
             m_vector.erase();
+            m_index.clear();
+            m_index_stale = false;
+        }
+
+        [[maybe_unused]] void erase(std::size_t index) {
+            m_vector.erase(index);
+            m_index_stale = true; // Every pair after index has shifted one position
         }
 
-        [[maybe_unused]] pair_template_reference erase(std::size_t index) {
-            return m_vector.erase(index);
+        // Rebuilds the hash index on the next key lookup, for after keys or pairs were changed through
+        // operator[], at, begin/end or raw
+        [[maybe_unused]] void reindex() {
+            m_index_stale = true;
         }
 
         // Debug print function
@@ -129,12 +296,15 @@ namespace mc {
 
         [[maybe_unused]] void sort() {
             /*
-             * This function will fail if typename T has no operator > function
+             * This function will fail if typename TKey has no operator < function
+             * Only the keys are compared, pairs with the same key keep their order
              */
 
-            return m_vector.sort();
+            m_index_stale = true;
+            mc::sorting::sort_by_key(m_vector.begin(), m_vector.end());
         }
 
+        // Call reindex() after reordering the pairs through these, e.g. with a std algorithm
         pair_template* begin() {
             return m_vector.begin();
         }
@@ -143,10 +313,32 @@ namespace mc {
             return m_vector.end();
         }
 
+        const pair_template* begin() const {
+            return m_vector.begin();
+        }
+
+        const pair_template* end() const {
+            return m_vector.end();
+        }
+
         // Copy assignment operator
-        [[maybe_unused]] map& operator=(const map other) {
+        [[maybe_unused]] map& operator=(const map& other) {
             // The operator= from mc::vector should handle this
             m_vector = other.raw();
+            m_index = other.m_index;
+            m_index_stale = other.m_index_stale;
+            return *this;
+        }
+
+        // Move assignment operator, the move assignment of mc::vector takes over the buffers
+        [[maybe_unused]] map& operator=(map&& other) noexcept(std::is_nothrow_move_assignable_v<vector_template>) {
+            if (this == &other) {
+                return *this;
+            }
+
+            m_vector = std::move(other.m_vector);
+            m_index = std::move(other.m_index);
+            m_index_stale = std::exchange(other.m_index_stale, false);
             return *this;
         }
 
@@ -159,18 +351,58 @@ namespace mc {
         }
 
     private:
+        using slots_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<std::size_t>;
+        using index_template = detail::hash_index<TKey, slots_allocator>;
+
+        static constexpr std::size_t NOT_FOUND{index_template::NOT_FOUND};
+
+        // The index finds keys through this, it reads the key out of the pair at a position
+        auto key_at() const {
+            return [this](std::size_t position) -> first_const_reference {
+                return m_vector[position].first;
+            };
+        }
+
+        // Returns the position of the pair with this key, or NOT_FOUND
+        template<typename Key>
+        std::size_t find_position(const Key& key) const {
+            refresh_index();
+            return m_index.find(key, key_at());
+        }
+
+        // Adds the last pushed back pair to the index
+        void index_last() {
+            if (m_index_stale) {
+                // It will be picked up when the index is rebuilt
+                return;
+            }
+
+            m_index.insert(m_vector.size() - 1, m_vector.size(), key_at());
+        }
+
+        void refresh_index() const {
+            if (m_index_stale) {
+                m_index.rebuild(m_vector.size(), key_at(), m_vector.size() * 2);
+                m_index_stale = false;
+            }
+        }
+
         vector_template m_vector;
+
+        // The index is a cache of m_vector, so const lookups may rebuild it
+        mutable index_template m_index;
+        mutable bool m_index_stale;
     };
 
     // Out stream operator for map
-    template<typename TKey, typename TValue>
-    std::ostream& operator<<(std::ostream& stream, map<TKey, TValue>& other) {
+    template<typename TKey, typename TValue, typename Allocator>
+    std::ostream& operator<<(std::ostream& stream, const map<TKey, TValue, Allocator>& other) {
         stream << other.raw();
         return stream;
     }
 
-    template<typename TKey, typename TValue>
-    bool operator==(const map<TKey, TValue>& a, const map<TKey, TValue>& b) {
+    template<typename TKey, typename TValue, typename Allocator>
+    bool operator==(const map<TKey, TValue, Allocator>& a, const map<TKey, TValue, Allocator>& b) {
         // Find the lowest index to avoid out of bounds
         if (a.size() != b.size()) {
             return false;
@@ -188,6 +420,12 @@ namespace mc {
         return a.capacity() == b.capacity();
     }
 
+    namespace pmr {
+        // A map that gets its memory from a std::pmr::memory_resource, e.g. a std::pmr::monotonic_buffer_resource
+        template<typename TKey, typename TValue>
+        using map = mc::map<TKey, TValue, std::pmr::polymorphic_allocator<mc::pair<TKey, TValue>>>;
+    }
+
 }
 
 #endif //APC_LIBRARY_MAP_H
@@ -0,0 +1,338 @@
+//
+// Created by Camiel Verdult on 17/10/2026.
+//
+
+#ifndef APC_LIBRARY_MMAP_VECTOR_H
+#define APC_LIBRARY_MMAP_VECTOR_H
+
+#include "instrumentation.h"
+#include "sort.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace mc {
+
+    // A vector whose elements live in a memory mapped file instead of on the heap.
+    // Everything that is pushed back ends up in the file, so opening the same file again (e.g. after a restart)
+    // gives back the same vector without reading or parsing anything. Only the pages that are touched are loaded.
+    //
+    // The file starts with a small header followed by the raw elements, so T has to be trivially copyable.
+    // The file is not portable between machines with a different endianness or layout of T
+    template <typename T>
+    class mmap_vector {
+        static_assert(std::is_trivially_copyable_v<T>, "mmap_vector stores the bytes of its elements in a file");
+
+    public:
+        using value_type = T;
+        using pointer = T*;
+        using const_pointer = const T*;
+        using reference = T&;
+        using const_reference = const T&;
+
+        static constexpr std::size_t DEFAULT_CAP{1024};
+
+        // Opens the vector stored in the file at path, or creates an empty one with room for capacity elements.
+        // Throws if the file can not be opened, holds a vector of a different element size or is damaged
+        explicit mmap_vector(const std::string& path, std::size_t capacity = DEFAULT_CAP) {
+            m_fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+
+            if (m_fd < 0) {
+                throw "mmap_vector_error: could not open the file\n";
+            }
+
+            struct stat status{};
+            if (::fstat(m_fd, &status) != 0) {
+                ::close(m_fd);
+                throw "mmap_vector_error: could not stat the file\n";
+            }
+
+            const bool is_new = status.st_size == 0;
+            std::size_t bytes = is_new ? file_size(std::max<std::size_t>(capacity, 1)) : static_cast<std::size_t>(status.st_size);
+
+            if (is_new and ::ftruncate(m_fd, static_cast<off_t>(bytes)) != 0) {
+                ::close(m_fd);
+                throw "mmap_vector_error: could not size the file\n";
+            }
+
+            if (bytes < sizeof(header)) {
+                ::close(m_fd);
+                throw "mmap_vector_error: the file is too small to hold a vector\n";
+            }
+
+            m_header = map(m_fd, bytes);
+
+            if (m_header == nullptr) {
+                ::close(m_fd);
+                throw "mmap_vector_error: could not map the file\n";
+            }
+
+            m_bytes = bytes;
+
+            if (is_new) {
+                *m_header = header{};
+            } else if (m_header->magic != MAGIC or m_header->version != VERSION or m_header->element_size != sizeof(T)) {
+                ::munmap(m_header, m_bytes);
+                ::close(m_fd);
+                throw "mmap_vector_error: the file does not hold a vector of this type\n";
+            } else if (m_header->size > this->capacity()) {
+                // A truncated file, or a header that was written over, would let us read past the mapping
+                ::munmap(m_header, m_bytes);
+                ::close(m_fd);
+                throw "mmap_vector_error: the file holds more elements than fit in it\n";
+            }
+
+            instrumentation::record<mmap_vector>(instrumentation::event_kind::allocate, m_bytes, this->capacity(), 0);
+        }
+
+        // There is only one mapping per file, so copies are not allowed
+        mmap_vector(const mmap_vector&) = delete;
+        mmap_vector& operator=(const mmap_vector&) = delete;
+
+        mmap_vector(mmap_vector&& other) noexcept:
+            m_fd{ std::exchange(other.m_fd, -1) },
+            m_header{ std::exchange(other.m_header, nullptr) },
+            m_bytes{ std::exchange(other.m_bytes, 0) } {}
+
+        mmap_vector& operator=(mmap_vector&& other) noexcept {
+            if (this != &other) {
+                close();
+                m_fd = std::exchange(other.m_fd, -1);
+                m_header = std::exchange(other.m_header, nullptr);
+                m_bytes = std::exchange(other.m_bytes, 0);
+            }
+
+            return *this;
+        }
+
+        // Unmapping writes the pages back eventually, call flush() first if they have to be on disk right away
+        ~mmap_vector() {
+            close();
+        }
+
+        // A moved-from vector has no file and no mapping. It is empty and has no room, it can be read (size, begin,
+        // end, ...), erased, flushed, destroyed and assigned to, but adding elements needs a file and throws
+        [[maybe_unused]] [[nodiscard]] std::size_t capacity() const noexcept {
+            return m_header != nullptr ? (m_bytes - sizeof(header)) / sizeof(T) : 0;
+        }
+
+        [[maybe_unused]] [[nodiscard]] std::size_t size() const noexcept {
+            return m_header != nullptr ? static_cast<std::size_t>(m_header->size) : 0;
+        }
+
+        [[maybe_unused]] const_pointer raw() const noexcept {
+            return data();
+        }
+
+        [[maybe_unused]] pointer raw() noexcept {
+            return data();
+        }
+
+        // Needs an open file, a moved-from vector throws
+        reference push_back(const_reference entry) {
+            // entry might point into our own mapping, which can move when the file grows
+            instrumentation::record<mmap_vector>(instrumentation::event_kind::copy, sizeof(T), 0, 1);
+            T copy = entry;
+
+            if (size() == capacity()) {
+                reserve(std::max<std::size_t>(capacity() * GROWTH_FACTOR, 1));
+            }
+
+            std::memcpy(static_cast<void*>(data() + size()), static_cast<const void*>(&copy), sizeof(T));
+            return data()[m_header->size++];
+        }
+
+        [[maybe_unused]] void pop_back() noexcept {
+            --m_header->size;
+        }
+
+        [[maybe_unused]] reference at(std::size_t index) {
+            if (index >= size()) {
+                // Index is out of bounds
+                throw "mmap_vector_error: at(i) is out of bounds\n";
+            }
+
+            return data()[index];
+        }
+
+        [[maybe_unused]] const_reference at(std::size_t index) const {
+            if (index >= size()) {
+                // Index is out of bounds
+                throw "mmap_vector_error: at(i) is out of bounds\n";
+            }
+
+            return data()[index];
+        }
+
+        [[maybe_unused]] reference operator[](std::size_t index) {
+            return data()[index];
+        }
+
+        [[maybe_unused]] const_reference operator[](std::size_t index) const {
+            return data()[index];
+        }
+
+        // Removes all elements, the file keeps its size
+        [[maybe_unused]] void erase() noexcept {
+            if (m_header != nullptr) {
+                m_header->size = 0;
+            }
+        }
+
+        // Grows the file so it fits at least new_capacity elements
+        [[maybe_unused]] void reserve(std::size_t new_capacity) {
+            if (new_capacity <= capacity()) {
+                return;
+            }
+
+            if (m_header == nullptr) {
+                // Moved from, there is no file to grow
+                throw "mmap_vector_error: the vector has no file, it was moved from\n";
+            }
+
+            if (new_capacity > (std::numeric_limits<std::size_t>::max() - sizeof(header)) / sizeof(T)) {
+                // The size of the file would not fit in a size_t
+                throw "mmap_vector_error: capacity is too large\n";
+            }
+
+            std::size_t bytes = file_size(new_capacity);
+            std::size_t old_bytes = m_bytes;
+
+            if (::ftruncate(m_fd, static_cast<off_t>(bytes)) != 0) {
+                throw "mmap_vector_error: could not grow the file\n";
+            }
+
+#ifdef __linux__
+            // mremap can often grow the mapping in place, or move it without copying any pages
+            void* mapping = ::mremap(m_header, m_bytes, bytes, MREMAP_MAYMOVE);
+
+            if (mapping == MAP_FAILED) {
+                throw "mmap_vector_error: could not grow the mapping\n";
+            }
+
+            m_header = static_cast<header*>(mapping);
+            m_bytes = bytes;
+            record_growth(old_bytes, new_capacity);
+#else
+            // Map the larger file first, if that fails the old mapping is still there and still valid
+            header* mapping = map(m_fd, bytes);
+
+            if (mapping == nullptr) {
+                throw "mmap_vector_error: could not grow the mapping\n";
+            }
+
+            ::munmap(m_header, m_bytes);
+            m_header = mapping;
+            m_bytes = bytes;
+            record_growth(old_bytes, new_capacity);
+#endif
+        }
+
+        // Writes all changed pages to the file and waits until they are on disk
+        [[maybe_unused]] void flush() {
+            if (m_header == nullptr) {
+                return;
+            }
+
+            if (::msync(m_header, m_bytes, MS_SYNC) != 0) {
+                throw "mmap_vector_error: could not flush the mapping\n";
+            }
+        }
+
+        [[maybe_unused]] void sort() {
+            /*
+             * This function will fail if typename T has no operator < function
+             * See sort.h for how the sorting strategy is picked
+             */
+
+            mc::sorting::sort(begin(), end());
+        }
+
+        const_pointer begin() const noexcept {
+            return data();
+        }
+
+        const_pointer end() const noexcept {
+            return data() + size();
+        }
+
+        pointer begin() noexcept {
+            return data();
+        }
+
+        pointer end() noexcept {
+            return data() + size();
+        }
+
+    private:
+        static constexpr std::size_t GROWTH_FACTOR{2};
+        static constexpr std::uint64_t MAGIC{0x524F544345564D4D}; // "MMVECTOR"
+        static constexpr std::uint32_t VERSION{1};
+
+        // Sits at the start of the file, 64 bytes so the elements after it are aligned for any T
+        struct alignas(64) header {
+            std::uint64_t magic = MAGIC;
+            std::uint32_t version = VERSION;
+            std::uint32_t element_size = sizeof(T);
+            std::uint64_t size = 0;
+        };
+
+        static_assert(alignof(T) <= alignof(header), "the elements are stored right after the header");
+
+        static std::size_t file_size(std::size_t capacity) noexcept {
+            return sizeof(header) + capacity * sizeof(T);
+        }
+
+        // Maps the first bytes of the file, returns nullptr if that fails
+        static header* map(int fd, std::size_t bytes) noexcept {
+            void* mapping = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            return mapping != MAP_FAILED ? static_cast<header*>(mapping) : nullptr;
+        }
+
+        // Growing the file counts like an mc::vector reallocation: the old mapping is freed and a bigger one made
+        void record_growth(std::size_t old_bytes, std::size_t new_capacity) noexcept {
+            instrumentation::record<mmap_vector>(instrumentation::event_kind::reallocate, 0, new_capacity, size());
+            instrumentation::record<mmap_vector>(instrumentation::event_kind::deallocate, old_bytes, 0, 0);
+            instrumentation::record<mmap_vector>(instrumentation::event_kind::allocate, m_bytes, new_capacity, 0);
+        }
+
+        void close() noexcept {
+            if (m_header != nullptr) {
+                instrumentation::record<mmap_vector>(instrumentation::event_kind::release, (capacity() - size()) * sizeof(T), capacity(), size());
+                instrumentation::record<mmap_vector>(instrumentation::event_kind::deallocate, m_bytes, 0, 0);
+                ::munmap(m_header, m_bytes);
+            }
+
+            if (m_fd >= 0) {
+                ::close(m_fd);
+            }
+        }
+
+        // The elements start right after the header, a moved-from vector has none
+        pointer data() noexcept {
+            return m_header != nullptr ? reinterpret_cast<pointer>(m_header + 1) : nullptr;
+        }
+
+        const_pointer data() const noexcept {
+            return m_header != nullptr ? reinterpret_cast<const_pointer>(m_header + 1) : nullptr;
+        }
+
+        int m_fd{-1};
+        header* m_header{nullptr};
+        std::size_t m_bytes{0};
+    };
+
+}
+
+#endif //APC_LIBRARY_MMAP_VECTOR_H
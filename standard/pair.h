@@ -34,21 +34,23 @@ namespace mc {
         // We use it anyway
         pair() = default;
 
-        // Parameterized constructor
-        pair(T1 first, T2 second): first {std::move(first)}, second {std::move(second)} {}
+        // Parameterized constructor, constexpr so pairs can be built at compile time (see mc::static_map)
+        constexpr pair(T1 first, T2 second): first {std::move(first)}, second {std::move(second)} {}
 
         // Copy constructor
-        pair(const pair& other): first{other.first}, second{other.second} {}
+        // Defaulted so that a pair of trivially copyable types is trivially copyable as well,
+        // mc::vector can then copy and move it with memcpy
+        pair(const pair& other) = default;
 
         // Copy assignment operator
-        pair& operator=(pair other) {
-            first = other.first;
-            second = other.second;
-            return *this;
-        }
+        pair& operator=(const pair& other) = default;
+
+        // Move constructor and move assignment operator, these move both members and are noexcept if theirs are
+        pair(pair&& other) = default;
+        pair& operator=(pair&& other) = default;
 
         // > compare operator
-        bool operator>(const pair<T1, T2>& other) const {
+        constexpr bool operator>(const pair<T1, T2>& other) const {
             if (first == other.first) {
                 return second > other.second;
             }
@@ -56,7 +58,7 @@ namespace mc {
         }
 
         // < compare operator
-        bool operator<(const pair<T1, T2>& other) const {
+        constexpr bool operator<(const pair<T1, T2>& other) const {
             if (first == other.first) {
                 return second < other.second;
             }
@@ -72,7 +74,7 @@ namespace mc {
 
     // Out stream operator for pair
     template <typename T1, typename T2>
-    std::ostream& operator<<(std::ostream& stream, pair<T1, T2>& other) {
+    std::ostream& operator<<(std::ostream& stream, const pair<T1, T2>& other) {
         stream << "(" << other.first << ", " << other.second << ")";
         return stream;
     }
@@ -85,7 +87,7 @@ namespace mc {
     // The inequality operator is automatically generated by the compiler if operator== is defined. (Since C++20)
     // See https://en.cppreference.com/w/cpp/language/operators
     template <typename T1, typename T2>
-    bool operator==(const pair<T1, T2>& a, const pair<T1, T2>& b) {
+    constexpr bool operator==(const pair<T1, T2>& a, const pair<T1, T2>& b) {
         return (a.first == b.first and a.second == b.second);
     }
 }
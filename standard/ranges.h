@@ -0,0 +1,116 @@
+//
+// Created by Camiel Verdult on 17/10/2026.
+//
+
+#ifndef APC_LIBRARY_RANGES_H
+#define APC_LIBRARY_RANGES_H
+
+#include "vector.h"
+
+#include <cstddef>
+#include <iterator>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+
+// mc::to, the end of a std::views pipeline that collects the elements into an mc container:
+//
+//     auto big = values | std::views::filter(is_big) | std::views::transform(twice) | mc::to<mc::vector>();
+//
+// The views in front of it are lazy, so this is the only place memory is allocated. If the number of elements can
+// be known up front (a sized range, or any forward range by walking it once) the container is allocated exactly
+// once with that capacity and never grows. C++23 has std::ranges::to for this, we are on C++20
+namespace mc {
+
+    namespace detail {
+        template <typename Container>
+        inline constexpr bool is_mc_vector_v = false;
+
+        template <typename T, typename GrowthPolicy, typename Allocator>
+        inline constexpr bool is_mc_vector_v<mc::vector<T, GrowthPolicy, Allocator>> = true;
+
+        // Collects range into a Container
+        template <typename Container, std::ranges::input_range Range>
+        Container collect(Range&& range) {
+            if constexpr (std::ranges::forward_range<Range>) {
+                // Counting is cheap compared to growing, a filter is walked twice but never allocates
+                auto count = static_cast<std::size_t>(std::ranges::distance(range));
+
+                Container result = [count] {
+                    if constexpr (is_mc_vector_v<Container>) {
+                        // The capacity constructor allocates once, the default one would allocate DEFAULT_CAP first
+                        return Container(count);
+                    } else {
+                        Container container{};
+
+                        if constexpr (requires { container.reserve(count); }) {
+                            container.reserve(count);
+                        }
+
+                        return container;
+                    }
+                }();
+
+                for (auto&& entry : range) {
+                    result.push_back(std::forward<decltype(entry)>(entry));
+                }
+
+                return result;
+            } else {
+                // Single pass, the size is not known so the container grows as usual
+                Container result{};
+
+                for (auto&& entry : range) {
+                    result.push_back(std::forward<decltype(entry)>(entry));
+                }
+
+                return result;
+            }
+        }
+
+        // What mc::to<mc::vector<int>>() returns
+        template <typename Container>
+        struct to_container {
+            template <std::ranges::input_range Range>
+            friend Container operator|(Range&& range, to_container) {
+                return collect<Container>(std::forward<Range>(range));
+            }
+        };
+
+        // What mc::to<mc::vector>() returns, the element type comes from the range
+        template <template <typename...> class Container>
+        struct to_template {
+            template <std::ranges::input_range Range>
+            friend auto operator|(Range&& range, to_template) {
+                using value_type = std::remove_cvref_t<std::ranges::range_reference_t<Range>>;
+                return collect<Container<value_type>>(std::forward<Range>(range));
+            }
+        };
+    }
+
+    // range | mc::to<mc::vector<int>>()
+    template <typename Container>
+    [[maybe_unused]] constexpr detail::to_container<Container> to() noexcept {
+        return {};
+    }
+
+    // range | mc::to<mc::vector>(), the element type is deduced from the range
+    template <template <typename...> class Container>
+    [[maybe_unused]] constexpr detail::to_template<Container> to() noexcept {
+        return {};
+    }
+
+    // Same as the pipe version: mc::to<mc::vector>(range)
+    template <typename Container, std::ranges::input_range Range>
+    [[maybe_unused]] Container to(Range&& range) {
+        return detail::collect<Container>(std::forward<Range>(range));
+    }
+
+    template <template <typename...> class Container, std::ranges::input_range Range>
+    [[maybe_unused]] auto to(Range&& range) {
+        using value_type = std::remove_cvref_t<std::ranges::range_reference_t<Range>>;
+        return detail::collect<Container<value_type>>(std::forward<Range>(range));
+    }
+}
+
+#endif //APC_LIBRARY_RANGES_H
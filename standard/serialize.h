@@ -0,0 +1,479 @@
+//
+// Created by Camiel Verdult on 17/10/2026.
+//
+
+#ifndef APC_LIBRARY_SERIALIZE_H
+#define APC_LIBRARY_SERIALIZE_H
+
+#include "map.h"
+#include "pair.h"
+#include "vector.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <span>
+#include <string>
+#include <type_traits>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+// A versioned binary format for mc::vector and mc::map.
+//
+// Every blob starts with a 32 byte header followed by the elements. Trivially copyable elements are written as one
+// contiguous block of their bytes, so writing and reading them is a single write/read call. Other elements are written
+// one by one through mc::serialization::codec, which knows std::string and mc::pair and can be specialised for more.
+//
+// For maps of trivially copyable pairs, mc::serialization::map_view reads a blob in place without copying anything.
+// Blobs are not portable between machines with a different endianness or layout of the elements
+namespace mc::serialization {
+
+    inline constexpr std::uint64_t MAGIC{0x4C41495245534D43}; // "MCSERIAL"
+    inline constexpr std::uint16_t VERSION{1};
+
+    enum class kind : std::uint8_t { vector = 1, map = 2 };
+
+    // Set in header::flags
+    inline constexpr std::uint8_t FLAG_CONTIGUOUS{1 << 0}; // the elements are one block of raw bytes
+    inline constexpr std::uint8_t FLAG_SORTED{1 << 1};     // the pairs of a map are sorted by key
+
+    // 32 bytes, so the elements after it are aligned for any element type with an alignment of up to 32
+    struct header {
+        std::uint64_t magic = MAGIC;
+        std::uint16_t version = VERSION;
+        kind type = kind::vector;
+        std::uint8_t flags = 0;
+        std::uint32_t element_size = 0;
+        std::uint64_t count = 0;
+        std::uint64_t payload_bytes = 0;
+    };
+
+    static_assert(sizeof(header) == 32);
+
+    // What source::available() returns when a pipe or a socket does not tell how much is left
+    inline constexpr std::size_t UNKNOWN_SIZE{std::numeric_limits<std::size_t>::max()};
+
+    // Without knowing how much a source holds, elements are read this many bytes at a time
+    inline constexpr std::size_t READ_CHUNK{1 << 20};
+
+    // Where bytes are written to, either a std::ostream or a file descriptor
+    struct sink {
+        std::ostream* stream = nullptr;
+        int fd = -1;
+
+        void write(const void* data, std::size_t bytes) const {
+            if (stream != nullptr) {
+                stream->write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+
+                if (not *stream) {
+                    throw "serialization_error: could not write to the stream\n";
+                }
+
+                return;
+            }
+
+            const auto* next = static_cast<const std::byte*>(data);
+
+            // write() may write less than asked for
+            while (bytes != 0) {
+                ssize_t written = ::write(fd, next, bytes);
+
+                if (written <= 0) {
+                    throw "serialization_error: could not write to the file descriptor\n";
+                }
+
+                next += written;
+                bytes -= static_cast<std::size_t>(written);
+            }
+        }
+    };
+
+    // Where bytes are read from, a std::istream, a file descriptor or a buffer in memory
+    struct source {
+        std::istream* stream = nullptr;
+        int fd = -1;
+        std::span<const std::byte> buffer{};
+
+        // The bytes that are known to be left, or UNKNOWN_SIZE. read_elements() asks available() once and read()
+        // counts it down, so codecs can check a length against it without asking the source again for every element
+        std::size_t budget = UNKNOWN_SIZE;
+
+        void read(void* data, std::size_t bytes) {
+            if (budget != UNKNOWN_SIZE) {
+                if (bytes > budget) {
+                    throw "serialization_error: unexpected end of the blob\n";
+                }
+
+                budget -= bytes;
+            }
+
+            if (stream != nullptr) {
+                stream->read(static_cast<char*>(data), static_cast<std::streamsize>(bytes));
+
+                if (not *stream) {
+                    throw "serialization_error: unexpected end of the stream\n";
+                }
+
+                return;
+            }
+
+            if (fd < 0) {
+                if (buffer.size() < bytes) {
+                    throw "serialization_error: unexpected end of the buffer\n";
+                }
+
+                if (bytes != 0) {
+                    std::memcpy(data, buffer.data(), bytes);
+                }
+
+                buffer = buffer.subspan(bytes);
+                return;
+            }
+
+            auto* next = static_cast<std::byte*>(data);
+
+            while (bytes != 0) {
+                ssize_t got = ::read(fd, next, bytes);
+
+                if (got <= 0) {
+                    throw "serialization_error: unexpected end of the file descriptor\n";
+                }
+
+                next += got;
+                bytes -= static_cast<std::size_t>(got);
+            }
+        }
+
+        // How many bytes are left to read, or UNKNOWN_SIZE if the source can not tell (a pipe, a socket, ...).
+        // For streams and file descriptors this seeks or makes system calls, so it is only asked once per blob
+        std::size_t available() {
+            if (stream != nullptr) {
+                const std::istream::pos_type position = stream->tellg();
+
+                if (position == std::istream::pos_type(-1)) {
+                    return UNKNOWN_SIZE;
+                }
+
+                stream->seekg(0, std::ios::end);
+                const std::istream::pos_type end = stream->tellg();
+                stream->clear();
+                stream->seekg(position);
+
+                if (end == std::istream::pos_type(-1)) {
+                    return UNKNOWN_SIZE;
+                }
+
+                return end > position ? static_cast<std::size_t>(end - position) : 0;
+            }
+
+            if (fd < 0) {
+                return buffer.size();
+            }
+
+            struct stat status{};
+            const off_t position = ::lseek(fd, 0, SEEK_CUR);
+
+            if (position < 0 or ::fstat(fd, &status) != 0 or not S_ISREG(status.st_mode)) {
+                return UNKNOWN_SIZE;
+            }
+
+            return status.st_size > position ? static_cast<std::size_t>(status.st_size - position) : 0;
+        }
+    };
+
+    // Writes and reads a single element. Trivially copyable types are their bytes,
+    // specialise this to support other element types
+    template <typename T, typename = void>
+    struct codec {
+        static_assert(std::is_trivially_copyable_v<T>, "no mc::serialization::codec for this element type");
+
+        static void write(const sink& out, const T& value) {
+            out.write(&value, sizeof(T));
+        }
+
+        static T read(source& in) {
+            T value;
+            in.read(&value, sizeof(T));
+            return value;
+        }
+    };
+
+    // Strings are their length followed by their characters
+    template <typename Char, typename Traits, typename Allocator>
+    struct codec<std::basic_string<Char, Traits, Allocator>> {
+        using string_type = std::basic_string<Char, Traits, Allocator>;
+
+        static void write(const sink& out, const string_type& value) {
+            auto length = static_cast<std::uint64_t>(value.size());
+            out.write(&length, sizeof(length));
+            out.write(value.data(), value.size() * sizeof(Char));
+        }
+
+        static string_type read(source& in) {
+            std::uint64_t length = 0;
+            in.read(&length, sizeof(length));
+
+            if (in.budget != UNKNOWN_SIZE and length > in.budget / sizeof(Char)) {
+                throw "serialization_error: a string is longer than what is left of the blob\n";
+            }
+
+            string_type value(static_cast<std::size_t>(length), Char{});
+            in.read(value.data(), value.size() * sizeof(Char));
+            return value;
+        }
+    };
+
+    // Pairs that are not trivially copyable are their first followed by their second
+    template <typename T1, typename T2>
+    struct codec<mc::pair<T1, T2>, std::enable_if_t<not std::is_trivially_copyable_v<mc::pair<T1, T2>>>> {
+        static void write(const sink& out, const mc::pair<T1, T2>& value) {
+            codec<T1>::write(out, value.first);
+            codec<T2>::write(out, value.second);
+        }
+
+        static mc::pair<T1, T2> read(source& in) {
+            T1 first = codec<T1>::read(in);
+            return {std::move(first), codec<T2>::read(in)};
+        }
+    };
+
+    namespace detail {
+        template <typename T>
+        void write_elements(const sink& out, kind type, std::uint8_t flags, const T* data, std::size_t count) {
+            header head{};
+            head.type = type;
+            head.flags = flags;
+            head.element_size = sizeof(T);
+            head.count = count;
+
+            if constexpr (std::is_trivially_copyable_v<T>) {
+                // One header and one block, nothing per element
+                head.flags |= FLAG_CONTIGUOUS;
+                head.payload_bytes = count * sizeof(T);
+
+                out.write(&head, sizeof(head));
+                out.write(data, count * sizeof(T));
+            } else {
+                out.write(&head, sizeof(head));
+
+                for (std::size_t i = 0; i < count; i++) {
+                    codec<T>::write(out, data[i]);
+                }
+            }
+        }
+
+        inline header read_header(source& in, kind type, std::size_t element_size) {
+            header head{};
+            in.read(&head, sizeof(head));
+
+            if (head.magic != MAGIC) {
+                throw "serialization_error: this is not a serialized mc container\n";
+            }
+
+            if (head.version != VERSION) {
+                throw "serialization_error: unsupported format version\n";
+            }
+
+            if (head.type != type or head.element_size != element_size) {
+                throw "serialization_error: the blob holds a different container or element type\n";
+            }
+
+            return head;
+        }
+
+        // FLAG_SORTED if the pairs are sorted by key, so map_view can binary search them
+        template <typename Vector>
+        std::uint8_t sorted_flag(const Vector& pairs) {
+            bool sorted = std::is_sorted(pairs.begin(), pairs.end(), [](const auto& a, const auto& b) {
+                return a.first < b.first;
+            });
+
+            return sorted ? FLAG_SORTED : 0;
+        }
+
+        // Reads the elements into a vector that is empty.
+        // The count in the header is not trusted: it has to match the payload and fit in what is left of the source,
+        // so a damaged or hostile blob can not make us allocate more memory than it actually holds
+        template <typename Vector>
+        void read_elements(source& in, const header& head, Vector& result) {
+            using T = typename Vector::value_type;
+
+            if (head.count > std::numeric_limits<std::size_t>::max() / std::max<std::size_t>(sizeof(T), 1)) {
+                throw "serialization_error: the element count is too large\n";
+            }
+
+            const auto count = static_cast<std::size_t>(head.count);
+            in.budget = in.available();
+            const std::size_t available = in.budget;
+
+            if constexpr (std::is_trivially_copyable_v<T> and std::is_default_constructible_v<T>) {
+                if ((head.flags & FLAG_CONTIGUOUS) == 0) {
+                    throw "serialization_error: expected a contiguous block of elements\n";
+                }
+
+                if (head.payload_bytes != count * sizeof(T)) {
+                    throw "serialization_error: the payload size does not match the element count\n";
+                }
+
+                if (available != UNKNOWN_SIZE and count * sizeof(T) > available) {
+                    throw "serialization_error: the blob is smaller than the elements it holds\n";
+                }
+
+                // resize() default-constructs, the trivially copyable elements are then overwritten in one read.
+                // If the size of the source is unknown the vector grows a chunk at a time as the bytes arrive
+                const std::size_t step = available == UNKNOWN_SIZE ? std::max<std::size_t>(READ_CHUNK / sizeof(T), 1) : count;
+
+                for (std::size_t done = 0; done < count;) {
+                    const std::size_t next = count - done > step ? done + step : count;
+
+                    result.resize(next);
+                    in.read(result.raw() + done, (next - done) * sizeof(T));
+                    done = next;
+                }
+            } else {
+                // Every element is at least one byte, past that push_back grows the vector as they are read
+                result.reserve(std::min(count, available != UNKNOWN_SIZE ? available : READ_CHUNK));
+
+                for (std::size_t i = 0; i < count; i++) {
+                    result.push_back(codec<T>::read(in));
+                }
+            }
+        }
+    }
+
+    // Writes the vector to a stream
+    template <typename T, typename GrowthPolicy, typename Allocator>
+    void serialize(const mc::vector<T, GrowthPolicy, Allocator>& vec, std::ostream& stream) {
+        detail::write_elements(sink{&stream}, kind::vector, 0, vec.raw(), vec.size());
+    }
+
+    // Writes the vector to a file descriptor
+    template <typename T, typename GrowthPolicy, typename Allocator>
+    void serialize(const mc::vector<T, GrowthPolicy, Allocator>& vec, int fd) {
+        detail::write_elements(sink{nullptr, fd}, kind::vector, 0, vec.raw(), vec.size());
+    }
+
+    // Writes the pairs of the map in their current order, sort() the map first to get a blob that map_view
+    // can search with a binary search
+    template <typename TKey, typename TValue, typename Allocator>
+    void serialize(const mc::map<TKey, TValue, Allocator>& map, std::ostream& stream) {
+        const auto& pairs = map.raw();
+        detail::write_elements(sink{&stream}, kind::map, detail::sorted_flag(pairs), pairs.raw(), pairs.size());
+    }
+
+    template <typename TKey, typename TValue, typename Allocator>
+    void serialize(const mc::map<TKey, TValue, Allocator>& map, int fd) {
+        const auto& pairs = map.raw();
+        detail::write_elements(sink{nullptr, fd}, kind::map, detail::sorted_flag(pairs), pairs.raw(), pairs.size());
+    }
+
+    // Reads a container of type Container (an mc::vector or mc::map) from a stream, a file descriptor or a buffer
+    template <typename Container>
+    Container deserialize(source in) {
+        Container result{};
+
+        if constexpr (requires { result.raw().raw(); }) {
+            // mc::map, the pairs go straight into the underlying vector and the hash index is rebuilt on first use
+            using pair_type = typename Container::pair_template;
+            header head = detail::read_header(in, kind::map, sizeof(pair_type));
+            detail::read_elements(in, head, result.raw());
+            result.reindex();
+        } else {
+            header head = detail::read_header(in, kind::vector, sizeof(typename Container::value_type));
+            detail::read_elements(in, head, result);
+        }
+
+        return result;
+    }
+
+    template <typename Container>
+    Container deserialize(std::istream& stream) {
+        return deserialize<Container>(source{&stream});
+    }
+
+    template <typename Container>
+    Container deserialize(int fd) {
+        return deserialize<Container>(source{nullptr, fd});
+    }
+
+    template <typename Container>
+    Container deserialize(std::span<const std::byte> buffer) {
+        return deserialize<Container>(source{nullptr, -1, buffer});
+    }
+
+    // A read-only map over a serialized mc::map of trivially copyable pairs, the pairs are used right where they are
+    // in the buffer. The buffer has to stay alive as long as the view and be aligned like the pairs.
+    // find() is a binary search if the map was sorted when it was serialized, a linear scan otherwise
+    template <typename TKey, typename TValue>
+    class map_view {
+    public:
+        using pair_template = mc::pair<TKey, TValue>;
+
+        static_assert(std::is_trivially_copyable_v<pair_template>, "map_view needs pairs that are their bytes");
+
+        explicit map_view(std::span<const std::byte> buffer) {
+            source in{nullptr, -1, buffer};
+            header head = detail::read_header(in, kind::map, sizeof(pair_template));
+
+            // Dividing instead of multiplying, a huge count would wrap around
+            if (head.count > in.buffer.size() / sizeof(pair_template) or head.payload_bytes != head.count * sizeof(pair_template)) {
+                throw "serialization_error: the buffer is smaller than the map it holds\n";
+            }
+
+            if (reinterpret_cast<std::uintptr_t>(in.buffer.data()) % alignof(pair_template) != 0) {
+                throw "serialization_error: the buffer is not aligned for the pairs\n";
+            }
+
+            m_pairs = reinterpret_cast<const pair_template*>(in.buffer.data());
+            m_size = static_cast<std::size_t>(head.count);
+            m_sorted = (head.flags & FLAG_SORTED) != 0;
+        }
+
+        [[maybe_unused]] [[nodiscard]] std::size_t size() const noexcept {
+            return m_size;
+        }
+
+        [[maybe_unused]] const pair_template& operator[](std::size_t index) const {
+            return m_pairs[index];
+        }
+
+        // Returns a pointer to the pair with this key, or end() if the key is not in the map
+        [[maybe_unused]] const pair_template* find(const TKey& key) const {
+            if (m_sorted) {
+                const pair_template* found = std::lower_bound(begin(), end(), key, [](const pair_template& entry, const TKey& k) {
+                    return entry.first < k;
+                });
+
+                return found != end() and found->first == key ? found : end();
+            }
+
+            return std::find_if(begin(), end(), [&key](const pair_template& entry) {
+                return entry.first == key;
+            });
+        }
+
+        [[maybe_unused]] [[nodiscard]] bool contains(const TKey& key) const {
+            return find(key) != end();
+        }
+
+        const pair_template* begin() const noexcept {
+            return m_pairs;
+        }
+
+        const pair_template* end() const noexcept {
+            return m_pairs + m_size;
+        }
+
+    private:
+        const pair_template* m_pairs;
+        std::size_t m_size;
+        bool m_sorted;
+    };
+}
+
+#endif //APC_LIBRARY_SERIALIZE_H
@@ -0,0 +1,463 @@
+//
+// Created by Camiel Verdult on 17/10/2026.
+//
+
+#ifndef APC_LIBRARY_SIMD_H
+#define APC_LIBRARY_SIMD_H
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__x86_64__) and (defined(__GNUC__) or defined(__clang__))
+#define MC_SIMD_X86 1
+#include <immintrin.h>
+#else
+#define MC_SIMD_X86 0
+#endif
+
+// Vectorised kernels for ranges of arithmetic values, used by mc::vector for operator==, find, count, min and max.
+// On x86-64 SSE2 is always there, AVX2 is picked at runtime when the CPU has it.
+// Everything else (other platforms, other compilers, other types) uses the plain scalar loops.
+// The results are exactly the same as those of the scalar loops, including +0.0 == -0.0 and NaN != NaN
+namespace mc::simd {
+
+    // Types the kernels work on, elements are compared with the instruction for their width
+    template <typename T>
+    inline constexpr bool is_vectorisable_v = std::is_arithmetic_v<T> and not std::is_same_v<T, bool>
+                                              and (sizeof(T) == 1 or sizeof(T) == 2 or sizeof(T) == 4 or sizeof(T) == 8);
+
+    enum class level { scalar, sse2, avx2 };
+
+    // The word-wise operations of bitwise(), bit_not ignores the second operand
+    enum class bit_op { bit_and, bit_or, bit_xor, bit_not };
+
+    // The best instruction set this CPU supports, this is only detected once
+    inline level detected_level() noexcept {
+#if MC_SIMD_X86
+        static const level detected = __builtin_cpu_supports("avx2") ? level::avx2 : level::sse2;
+        return detected;
+#else
+        return level::scalar;
+#endif
+    }
+
+    namespace scalar {
+        template <typename T>
+        bool equal(const T* a, const T* b, std::size_t count) {
+            for (std::size_t i = 0; i < count; i++) {
+                if (a[i] != b[i])
+                    return false;
+            }
+
+            return true;
+        }
+
+        template <typename T>
+        std::size_t find(const T* data, std::size_t count, const T& value) {
+            return static_cast<std::size_t>(std::find(data, data + count, value) - data);
+        }
+
+        template <typename T>
+        std::size_t count(const T* data, std::size_t count, const T& value) {
+            return static_cast<std::size_t>(std::count(data, data + count, value));
+        }
+
+        template <typename T>
+        std::size_t min_index(const T* data, std::size_t count) {
+            return static_cast<std::size_t>(std::min_element(data, data + count) - data);
+        }
+
+        template <typename T>
+        std::size_t max_index(const T* data, std::size_t count) {
+            return static_cast<std::size_t>(std::max_element(data, data + count) - data);
+        }
+
+        inline std::size_t popcount(const std::uint64_t* words, std::size_t count) {
+            std::size_t bits = 0;
+
+            for (std::size_t i = 0; i < count; i++) {
+                bits += static_cast<std::size_t>(std::popcount(words[i]));
+            }
+
+            return bits;
+        }
+
+        template <bit_op Op>
+        void bitwise(std::uint64_t* target, const std::uint64_t* source, std::size_t count) {
+            for (std::size_t i = 0; i < count; i++) {
+                if constexpr (Op == bit_op::bit_and) target[i] &= source[i];
+                else if constexpr (Op == bit_op::bit_or) target[i] |= source[i];
+                else if constexpr (Op == bit_op::bit_xor) target[i] ^= source[i];
+                else target[i] = ~target[i];
+            }
+        }
+    }
+
+#if MC_SIMD_X86
+    namespace sse2 {
+        // Gives a bit per byte that is set when the element that byte belongs to is equal in a and b
+        template <typename T>
+        std::uint32_t equal_mask(__m128i a, __m128i b) noexcept {
+            if constexpr (std::is_same_v<T, float>) {
+                return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_castps_si128(_mm_cmpeq_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b)))));
+            } else if constexpr (std::is_same_v<T, double>) {
+                return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_castpd_si128(_mm_cmpeq_pd(_mm_castsi128_pd(a), _mm_castsi128_pd(b)))));
+            } else if constexpr (sizeof(T) == 1) {
+                return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)));
+            } else if constexpr (sizeof(T) == 2) {
+                return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi16(a, b)));
+            } else if constexpr (sizeof(T) == 4) {
+                return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi32(a, b)));
+            } else {
+                // SSE2 has no 64 bit compare, both 32 bit halves have to be equal
+                __m128i halves = _mm_cmpeq_epi32(a, b);
+                __m128i swapped = _mm_shuffle_epi32(halves, _MM_SHUFFLE(2, 3, 0, 1));
+                return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_and_si128(halves, swapped)));
+            }
+        }
+
+        template <typename T>
+        __m128i broadcast(T value) noexcept {
+            if constexpr (sizeof(T) == 1) {
+                return _mm_set1_epi8(std::bit_cast<char>(value));
+            } else if constexpr (sizeof(T) == 2) {
+                return _mm_set1_epi16(std::bit_cast<short>(value));
+            } else if constexpr (sizeof(T) == 4) {
+                return _mm_set1_epi32(std::bit_cast<int>(value));
+            } else {
+                return _mm_set1_epi64x(std::bit_cast<long long>(value));
+            }
+        }
+
+        inline __m128i load(const void* data) noexcept {
+            return _mm_loadu_si128(static_cast<const __m128i*>(data));
+        }
+
+        constexpr std::uint32_t ALL_EQUAL{0xFFFF};
+
+        template <typename T>
+        bool equal(const T* a, const T* b, std::size_t count) noexcept {
+            constexpr std::size_t step = 16 / sizeof(T);
+            std::size_t i = 0;
+
+            for (; i + step <= count; i += step) {
+                if (equal_mask<T>(load(a + i), load(b + i)) != ALL_EQUAL)
+                    return false;
+            }
+
+            return scalar::equal(a + i, b + i, count - i);
+        }
+
+        template <typename T>
+        std::size_t find(const T* data, std::size_t count, T value) noexcept {
+            constexpr std::size_t step = 16 / sizeof(T);
+            const __m128i needle = broadcast(value);
+            std::size_t i = 0;
+
+            for (; i + step <= count; i += step) {
+                std::uint32_t mask = equal_mask<T>(load(data + i), needle);
+
+                if (mask != 0)
+                    return i + static_cast<std::size_t>(std::countr_zero(mask)) / sizeof(T);
+            }
+
+            return i + scalar::find(data + i, count - i, value);
+        }
+
+        template <typename T>
+        std::size_t count(const T* data, std::size_t count, T value) noexcept {
+            constexpr std::size_t step = 16 / sizeof(T);
+            const __m128i needle = broadcast(value);
+            std::size_t found = 0;
+            std::size_t i = 0;
+
+            for (; i + step <= count; i += step) {
+                found += static_cast<std::size_t>(std::popcount(equal_mask<T>(load(data + i), needle))) / sizeof(T);
+            }
+
+            return found + scalar::count(data + i, count - i, value);
+        }
+
+        // Two words at a time
+        template <bit_op Op>
+        void bitwise(std::uint64_t* target, const std::uint64_t* source, std::size_t count) noexcept {
+            std::size_t i = 0;
+
+            for (; i + 2 <= count; i += 2) {
+                __m128i a = load(target + i);
+                __m128i result;
+
+                if constexpr (Op == bit_op::bit_and) result = _mm_and_si128(a, load(source + i));
+                else if constexpr (Op == bit_op::bit_or) result = _mm_or_si128(a, load(source + i));
+                else if constexpr (Op == bit_op::bit_xor) result = _mm_xor_si128(a, load(source + i));
+                else result = _mm_xor_si128(a, _mm_set1_epi32(-1));
+
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(target + i), result);
+            }
+
+            scalar::bitwise<Op>(target + i, source + i, count - i);
+        }
+    }
+
+    namespace avx2 {
+        // Same as sse2::equal_mask, but for 32 bytes at a time
+        template <typename T>
+        [[gnu::target("avx2")]] std::uint32_t equal_mask(__m256i a, __m256i b) noexcept {
+            if constexpr (std::is_same_v<T, float>) {
+                return static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_castps_si256(_mm256_cmp_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b), _CMP_EQ_OQ))));
+            } else if constexpr (std::is_same_v<T, double>) {
+                return static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_castpd_si256(_mm256_cmp_pd(_mm256_castsi256_pd(a), _mm256_castsi256_pd(b), _CMP_EQ_OQ))));
+            } else if constexpr (sizeof(T) == 1) {
+                return static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b)));
+            } else if constexpr (sizeof(T) == 2) {
+                return static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi16(a, b)));
+            } else if constexpr (sizeof(T) == 4) {
+                return static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi32(a, b)));
+            } else {
+                return static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi64(a, b)));
+            }
+        }
+
+        template <typename T>
+        [[gnu::target("avx2")]] __m256i broadcast(T value) noexcept {
+            if constexpr (sizeof(T) == 1) {
+                return _mm256_set1_epi8(std::bit_cast<char>(value));
+            } else if constexpr (sizeof(T) == 2) {
+                return _mm256_set1_epi16(std::bit_cast<short>(value));
+            } else if constexpr (sizeof(T) == 4) {
+                return _mm256_set1_epi32(std::bit_cast<int>(value));
+            } else {
+                return _mm256_set1_epi64x(std::bit_cast<long long>(value));
+            }
+        }
+
+        [[gnu::target("avx2")]] inline __m256i load(const void* data) noexcept {
+            return _mm256_loadu_si256(static_cast<const __m256i*>(data));
+        }
+
+        constexpr std::uint32_t ALL_EQUAL{0xFFFFFFFF};
+
+        template <typename T>
+        [[gnu::target("avx2")]] bool equal(const T* a, const T* b, std::size_t count) noexcept {
+            constexpr std::size_t step = 32 / sizeof(T);
+            std::size_t i = 0;
+
+            for (; i + step <= count; i += step) {
+                if (equal_mask<T>(load(a + i), load(b + i)) != ALL_EQUAL)
+                    return false;
+            }
+
+            return scalar::equal(a + i, b + i, count - i);
+        }
+
+        template <typename T>
+        [[gnu::target("avx2")]] std::size_t find(const T* data, std::size_t count, T value) noexcept {
+            constexpr std::size_t step = 32 / sizeof(T);
+            const __m256i needle = broadcast(value);
+            std::size_t i = 0;
+
+            for (; i + step <= count; i += step) {
+                std::uint32_t mask = equal_mask<T>(load(data + i), needle);
+
+                if (mask != 0)
+                    return i + static_cast<std::size_t>(std::countr_zero(mask)) / sizeof(T);
+            }
+
+            return i + scalar::find(data + i, count - i, value);
+        }
+
+        template <typename T>
+        [[gnu::target("avx2")]] std::size_t count(const T* data, std::size_t count, T value) noexcept {
+            constexpr std::size_t step = 32 / sizeof(T);
+            const __m256i needle = broadcast(value);
+            std::size_t found = 0;
+            std::size_t i = 0;
+
+            for (; i + step <= count; i += step) {
+                found += static_cast<std::size_t>(std::popcount(equal_mask<T>(load(data + i), needle))) / sizeof(T);
+            }
+
+            return found + scalar::count(data + i, count - i, value);
+        }
+
+        // AVX2 only has min and max for integers up to 32 bits, floats are left to the scalar loop
+        // because of how _mm256_min_ps treats NaN
+        template <typename T>
+        inline constexpr bool has_min_max_v = std::is_integral_v<T> and sizeof(T) <= 4;
+
+        template <typename T, bool Max>
+        [[gnu::target("avx2")]] __m256i min_max(__m256i a, __m256i b) noexcept {
+            constexpr bool is_signed = std::is_signed_v<T>;
+
+            if constexpr (sizeof(T) == 1) {
+                if constexpr (is_signed) return Max ? _mm256_max_epi8(a, b) : _mm256_min_epi8(a, b);
+                else return Max ? _mm256_max_epu8(a, b) : _mm256_min_epu8(a, b);
+            } else if constexpr (sizeof(T) == 2) {
+                if constexpr (is_signed) return Max ? _mm256_max_epi16(a, b) : _mm256_min_epi16(a, b);
+                else return Max ? _mm256_max_epu16(a, b) : _mm256_min_epu16(a, b);
+            } else {
+                if constexpr (is_signed) return Max ? _mm256_max_epi32(a, b) : _mm256_min_epi32(a, b);
+                else return Max ? _mm256_max_epu32(a, b) : _mm256_min_epu32(a, b);
+            }
+        }
+
+        // Finds the smallest (or largest) value with vector instructions and then its first index with find,
+        // which gives the same index as std::min_element (or std::max_element)
+        template <typename T, bool Max>
+        [[gnu::target("avx2")]] std::size_t extreme_index(const T* data, std::size_t count) noexcept {
+            constexpr std::size_t step = 32 / sizeof(T);
+
+            if (count < step) {
+                return Max ? scalar::max_index(data, count) : scalar::min_index(data, count);
+            }
+
+            __m256i best = load(data);
+            std::size_t i = step;
+
+            for (; i + step <= count; i += step) {
+                best = min_max<T, Max>(best, load(data + i));
+            }
+
+            T lanes[step];
+            std::memcpy(lanes, &best, sizeof(best));
+
+            T extreme = Max ? *std::max_element(lanes, lanes + step) : *std::min_element(lanes, lanes + step);
+
+            for (; i < count; i++) {
+                extreme = Max ? std::max(extreme, data[i]) : std::min(extreme, data[i]);
+            }
+
+            return find(data, count, extreme);
+        }
+
+        // Every CPU with AVX2 also has the popcnt instruction, without it std::popcount is a series of shifts and adds.
+        // Four independent counters so the popcnt instructions do not wait on each other
+        [[gnu::target("avx2,popcnt")]] inline std::size_t popcount(const std::uint64_t* words, std::size_t count) noexcept {
+            std::uint64_t bits[4]{};
+            std::size_t i = 0;
+
+            for (; i + 4 <= count; i += 4) {
+                bits[0] += static_cast<std::uint64_t>(_mm_popcnt_u64(words[i]));
+                bits[1] += static_cast<std::uint64_t>(_mm_popcnt_u64(words[i + 1]));
+                bits[2] += static_cast<std::uint64_t>(_mm_popcnt_u64(words[i + 2]));
+                bits[3] += static_cast<std::uint64_t>(_mm_popcnt_u64(words[i + 3]));
+            }
+
+            for (; i < count; i++) {
+                bits[0] += static_cast<std::uint64_t>(_mm_popcnt_u64(words[i]));
+            }
+
+            return static_cast<std::size_t>(bits[0] + bits[1] + bits[2] + bits[3]);
+        }
+
+        // Four words at a time
+        template <bit_op Op>
+        [[gnu::target("avx2")]] void bitwise(std::uint64_t* target, const std::uint64_t* source, std::size_t count) noexcept {
+            std::size_t i = 0;
+
+            for (; i + 4 <= count; i += 4) {
+                __m256i a = load(target + i);
+                __m256i result;
+
+                if constexpr (Op == bit_op::bit_and) result = _mm256_and_si256(a, load(source + i));
+                else if constexpr (Op == bit_op::bit_or) result = _mm256_or_si256(a, load(source + i));
+                else if constexpr (Op == bit_op::bit_xor) result = _mm256_xor_si256(a, load(source + i));
+                else result = _mm256_xor_si256(a, _mm256_set1_epi32(-1));
+
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(target + i), result);
+            }
+
+            scalar::bitwise<Op>(target + i, source + i, count - i);
+        }
+    }
+#endif
+
+    // Returns whether the first count elements of a and b are equal
+    template <typename T>
+    bool equal(const T* a, const T* b, std::size_t count) {
+#if MC_SIMD_X86
+        if constexpr (is_vectorisable_v<T>) {
+            if (detected_level() == level::avx2)
+                return avx2::equal(a, b, count);
+            return sse2::equal(a, b, count);
+        }
+#endif
+        return scalar::equal(a, b, count);
+    }
+
+    // Returns the index of the first element equal to value, or count if there is none
+    template <typename T>
+    std::size_t find(const T* data, std::size_t count, const T& value) {
+#if MC_SIMD_X86
+        if constexpr (is_vectorisable_v<T>) {
+            if (detected_level() == level::avx2)
+                return avx2::find(data, count, value);
+            return sse2::find(data, count, value);
+        }
+#endif
+        return scalar::find(data, count, value);
+    }
+
+    // Returns how many elements are equal to value
+    template <typename T>
+    std::size_t count(const T* data, std::size_t count, const T& value) {
+#if MC_SIMD_X86
+        if constexpr (is_vectorisable_v<T>) {
+            if (detected_level() == level::avx2)
+                return avx2::count(data, count, value);
+            return sse2::count(data, count, value);
+        }
+#endif
+        return scalar::count(data, count, value);
+    }
+
+    // Returns the index of the first smallest element, or count if there are no elements
+    template <typename T>
+    std::size_t min_index(const T* data, std::size_t count) {
+#if MC_SIMD_X86
+        if constexpr (is_vectorisable_v<T> and avx2::has_min_max_v<T>) {
+            if (detected_level() == level::avx2)
+                return avx2::extreme_index<T, false>(data, count);
+        }
+#endif
+        return scalar::min_index(data, count);
+    }
+
+    // Returns the index of the first largest element, or count if there are no elements
+    template <typename T>
+    std::size_t max_index(const T* data, std::size_t count) {
+#if MC_SIMD_X86
+        if constexpr (is_vectorisable_v<T> and avx2::has_min_max_v<T>) {
+            if (detected_level() == level::avx2)
+                return avx2::extreme_index<T, true>(data, count);
+        }
+#endif
+        return scalar::max_index(data, count);
+    }
+
+    // Returns the number of set bits in the first count words
+    inline std::size_t popcount(const std::uint64_t* words, std::size_t count) {
+#if MC_SIMD_X86
+        if (detected_level() == level::avx2)
+            return avx2::popcount(words, count);
+#endif
+        return scalar::popcount(words, count);
+    }
+
+    // target[i] = target[i] Op source[i] for the first count words. source is not read for bit_not, pass target for it
+    template <bit_op Op>
+    void bitwise(std::uint64_t* target, const std::uint64_t* source, std::size_t count) {
+#if MC_SIMD_X86
+        if (detected_level() == level::avx2)
+            return avx2::bitwise<Op>(target, source, count);
+        return sse2::bitwise<Op>(target, source, count);
+#endif
+        return scalar::bitwise<Op>(target, source, count);
+    }
+}
+
+#endif //APC_LIBRARY_SIMD_H
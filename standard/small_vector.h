@@ -0,0 +1,370 @@
+//
+// Created by Camiel Verdult on 17/10/2026.
+//
+
+#ifndef APC_LIBRARY_SMALL_VECTOR_H
+#define APC_LIBRARY_SMALL_VECTOR_H
+
+#include "vector.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iostream>
+#include <memory>
+#include <type_traits>
+
+namespace mc {
+
+    // A vector that keeps its first N elements inside the object itself.
+    // Only when the N+1th element is pushed back the elements move to the heap, after that it behaves like mc::vector.
+    // Most vectors stay small, so for those this saves the heap allocation and keeps the data next to the object
+    template <typename T, std::size_t N, typename GrowthPolicy = growth::doubling>
+    class small_vector {
+        static_assert(N > 0, "use mc::vector if you do not want inline storage");
+
+    public:
+        using value_type = T;
+        using pointer = T*;
+        using const_pointer = const T*;
+        using reference = T&;
+        using const_reference = const T&;
+        using growth_policy = GrowthPolicy;
+
+        static constexpr std::size_t INLINE_CAP{N};
+
+        // Default constructor, this does not allocate anything
+        small_vector():
+            m_data{ inline_data() },
+            m_cap{ N },
+            m_sz{ 0 } {}
+
+        // Initializer list constructor
+        small_vector(std::initializer_list<T> list) : small_vector() {
+            reserve(list.size());
+
+            for (auto& entry : list) {
+                push_back(entry);
+            }
+        }
+
+        // Copy constructor, like mc::vector this copies the capacity of other as well
+        small_vector(const small_vector& other) : small_vector() {
+            reserve(other.capacity());
+            instrumentation::record<small_vector>(instrumentation::event_kind::copy, other.size() * sizeof(T), 0, other.size());
+            std::uninitialized_copy(other.begin(), other.end(), m_data);
+            m_sz = other.size();
+        }
+
+        // Move constructor, a heap buffer is taken over, inline elements have to be moved one by one
+        small_vector(small_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) : small_vector() {
+            take(other);
+        }
+
+        ~small_vector() {
+            // Only a heap buffer counts, the inline storage is part of the object
+            if (on_heap()) {
+                instrumentation::record<small_vector>(instrumentation::event_kind::release, (m_cap - m_sz) * sizeof(T), m_cap, m_sz);
+            }
+
+            std::destroy_n(m_data, m_sz);
+            release();
+        }
+
+        // Copy assignment operator
+        [[maybe_unused]] small_vector& operator=(const small_vector& other) {
+            if (this == &other) {
+                return *this;
+            }
+
+            // Copy into a temporary first so we are left untouched if a copy constructor throws
+            small_vector copy{other};
+
+            return *this = std::move(copy);
+        }
+
+        // Move assignment operator
+        [[maybe_unused]] small_vector& operator=(small_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+            if (this == &other) {
+                return *this;
+            }
+
+            clear();
+            release();
+
+            m_data = inline_data();
+            m_cap = N;
+
+            take(other);
+            return *this;
+        }
+
+        [[maybe_unused]] [[nodiscard]] std::size_t capacity() const noexcept {
+            return m_cap;
+        }
+
+        [[maybe_unused]] [[nodiscard]] std::size_t size() const noexcept {
+            return m_sz;
+        }
+
+        // Whether the elements live in a heap allocation instead of inside the object
+        [[maybe_unused]] [[nodiscard]] bool on_heap() const noexcept {
+            return m_data != inline_data();
+        }
+
+        [[maybe_unused]] const_pointer raw() const noexcept {
+            return m_data;
+        }
+
+        [[maybe_unused]] pointer raw() noexcept {
+            return m_data;
+        }
+
+        reference push_back(const_reference entry) {
+            return emplace_back(entry);
+        }
+
+        reference push_back(value_type&& entry) {
+            return emplace_back(std::move(entry));
+        }
+
+        // Constructs the new element in place from args and returns a reference to it
+        template <typename... Args>
+        reference emplace_back(Args&&... args) {
+            instrumentation::record_construct<small_vector, T, Args...>();
+
+            if (m_sz == m_cap) {
+                // args might refer to one of our own elements, so build it before the elements move
+                value_type entry(std::forward<Args>(args)...);
+                reallocate(GrowthPolicy::next_capacity(m_cap, m_sz + 1, sizeof(T)));
+                std::construct_at(m_data + m_sz, std::move(entry));
+            } else {
+                std::construct_at(m_data + m_sz, std::forward<Args>(args)...);
+            }
+
+            return m_data[m_sz++];
+        }
+
+        [[maybe_unused]] reference insert(const std::size_t index, const_reference entry) {
+            return emplace(index, entry);
+        }
+
+        [[maybe_unused]] reference insert(const std::size_t index, value_type&& entry) {
+            return emplace(index, std::move(entry));
+        }
+
+        // Constructs a new element from args at index, the elements from index onwards shift one place.
+        // An index past the end appends
+        template <typename... Args>
+        [[maybe_unused]] reference emplace(const std::size_t index, Args&&... args) {
+            if (index >= m_sz) {
+                return emplace_back(std::forward<Args>(args)...);
+            }
+
+            instrumentation::record_construct<small_vector, T, Args...>();
+            value_type entry(std::forward<Args>(args)...);
+
+            if (m_sz == m_cap) {
+                reallocate(GrowthPolicy::next_capacity(m_cap, m_sz + 1, sizeof(T)));
+            }
+
+            // The slot at m_sz is raw memory, so the last element has to be move-constructed into it
+            std::construct_at(m_data + m_sz, std::move(m_data[m_sz - 1]));
+            std::move_backward(m_data + index, m_data + m_sz - 1, m_data + m_sz);
+            m_sz++;
+
+            m_data[index] = std::move(entry);
+            return m_data[index];
+        }
+
+        [[maybe_unused]] reference at(std::size_t index) {
+            if (index >= m_sz) {
+                // Index is out of bounds
+                throw "small_vector_error: at(i) is out of bounds\n";
+            }
+
+            return m_data[index];
+        }
+
+        [[maybe_unused]] const_reference at(std::size_t index) const {
+            if (index >= m_sz) {
+                // Index is out of bounds
+                throw "small_vector_error: at(i) is out of bounds\n";
+            }
+
+            return m_data[index];
+        }
+
+        [[maybe_unused]] void pop_back() noexcept {
+            std::destroy_at(m_data + m_sz - 1);
+            --m_sz;
+        }
+
+        [[maybe_unused]] reference operator[](std::size_t index) {
+            return m_data[index];
+        }
+
+        [[maybe_unused]] const_reference operator[](std::size_t index) const {
+            return m_data[index];
+        }
+
+        [[maybe_unused]] void erase() {
+            clear();
+        }
+
+        [[maybe_unused]] void erase(std::size_t index) {
+            if (index >= m_sz) {
+                // Index is out of bounds
+                throw "small_vector_error: erase(i) is out of bounds\n";
+            }
+
+            // Shift all data back and destroy the now moved-from last element
+            std::move(m_data + index + 1, m_data + m_sz, m_data + index);
+            std::destroy_at(m_data + m_sz - 1);
+
+            m_sz--;
+        }
+
+        [[maybe_unused]] void clear() noexcept {
+            std::destroy_n(m_data, m_sz);
+            m_sz = 0;
+        }
+
+        // Makes sure there is room for at least new_capacity elements, this moves to the heap if N is too small
+        [[maybe_unused]] void reserve(std::size_t new_capacity) {
+            if (new_capacity > m_cap) {
+                reallocate(new_capacity);
+            }
+        }
+
+        // Debug print function
+        void debug_print(std::ostream& stream = std::cout) {
+            for (std::size_t i = 0; i < m_sz; i++)
+                stream << "Index: " << i << " = " << m_data[i];
+        }
+
+        [[maybe_unused]] void sort() {
+            /*
+             * This function will fail if typename T has no operator < function
+             * See sort.h for how the sorting strategy is picked
+             */
+
+            mc::sorting::sort(begin(), end());
+        }
+
+        const_pointer begin() const noexcept {
+            return m_data;
+        }
+
+        const_pointer end() const noexcept {
+            return m_data + m_sz;
+        }
+
+        pointer begin() noexcept {
+            return m_data;
+        }
+
+        pointer end() noexcept {
+            return m_data + m_sz;
+        }
+
+    private:
+        pointer inline_data() noexcept {
+            return reinterpret_cast<pointer>(m_inline);
+        }
+
+        const_pointer inline_data() const noexcept {
+            return reinterpret_cast<const_pointer>(m_inline);
+        }
+
+        // Moves the elements to a heap buffer of exactly new_capacity, which has to fit all elements
+        void reallocate(std::size_t new_capacity) {
+            pointer replacement = std::allocator<T>{}.allocate(new_capacity);
+
+            // uninitialized_move destroys what it already built if a move throws, the buffer is ours to free
+            try {
+                std::uninitialized_move(begin(), end(), replacement);
+            } catch (...) {
+                std::allocator<T>{}.deallocate(replacement, new_capacity);
+                throw;
+            }
+
+            instrumentation::record<small_vector>(instrumentation::event_kind::reallocate, 0, new_capacity, m_sz);
+            instrumentation::record<small_vector>(instrumentation::event_kind::allocate, new_capacity * sizeof(T), new_capacity, 0);
+
+            std::destroy_n(m_data, m_sz);
+            release();
+
+            m_data = replacement;
+            m_cap = new_capacity;
+        }
+
+        // Takes over the elements of other while we are empty and inline, other is left empty and inline
+        void take(small_vector& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+            if (other.on_heap()) {
+                m_data = other.m_data;
+                m_cap = other.m_cap;
+                m_sz = other.m_sz;
+            } else {
+                std::uninitialized_move(other.begin(), other.end(), m_data);
+                m_sz = other.m_sz;
+                other.clear();
+            }
+
+            other.m_data = other.inline_data();
+            other.m_cap = N;
+            other.m_sz = 0;
+        }
+
+        // Frees the heap buffer if we have one, the elements must be destroyed already
+        void release() noexcept {
+            if (on_heap()) {
+                instrumentation::record<small_vector>(instrumentation::event_kind::deallocate, m_cap * sizeof(T), m_cap, 0);
+                std::allocator<T>{}.deallocate(m_data, m_cap);
+            }
+        }
+
+        // Raw inline storage, elements are only constructed when they are pushed back
+        alignas(T) std::byte m_inline[N * sizeof(T)];
+
+        pointer m_data;
+        std::size_t m_cap;
+        std::size_t m_sz;
+    };
+
+    // Out stream operator for small_vector
+    template <typename T, std::size_t N, typename GrowthPolicy>
+    std::ostream& operator<<(std::ostream& stream, small_vector<T, N, GrowthPolicy>& other) {
+
+        stream << "mc::small_vector{";
+
+        for (std::size_t i = 0; i < other.size(); i++) {
+            stream << other[i];
+            // Add ', ' between every element except the last
+            if (i != other.size() - 1)
+                stream << ", ";
+        }
+
+        stream << "}";
+
+        return stream;
+    }
+
+    // Same rules as operator== of mc::vector, the capacity has to match as well
+    template <typename T, std::size_t N, typename GrowthPolicy>
+    bool operator==(const small_vector<T, N, GrowthPolicy>& a, const small_vector<T, N, GrowthPolicy>& b) {
+        if (a.size() != b.size()) {
+            return false;
+        }
+
+        for (std::size_t i = 0; i < a.size(); i++) {
+            if (a[i] != b[i])
+                return false;
+        }
+
+        return a.capacity() == b.capacity();
+    }
+
+}
+
+#endif //APC_LIBRARY_SMALL_VECTOR_H
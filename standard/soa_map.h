@@ -0,0 +1,184 @@
+//
+// Created by Camiel Verdult on 17/10/2026.
+//
+
+#ifndef APC_LIBRARY_SOA_MAP_H
+#define APC_LIBRARY_SOA_MAP_H
+
+#include "hash.h"
+#include "hash_index.h"
+#include "pair.h"
+#include "soa_vector.h"
+
+#include <cstddef>
+#include <span>
+#include <utility>
+
+namespace mc {
+
+    // The same hash map as mc::map, but the keys and the values live in two separate columns of an mc::soa_vector
+    // instead of in mc::pairs. Lookups and key scans only touch the keys, which are packed together in one
+    // contiguous block, so more of them fit in every cache line. Use keys() and values() to scan one of the two.
+    //
+    // Like mc::map, pairs stay in insertion order and erase_key moves the last pair into the gap.
+    // Unlike mc::map every key is in the map at most once, there is no push_back that allows duplicates
+    template<typename TKey, typename TValue>
+    class soa_map {
+    public:
+
+        using first_type = TKey;
+        using first_const_reference = const TKey&;
+
+        using second_type = TValue;
+        using second_pointer = TValue*;
+
+        using rows_template = mc::soa_vector<TKey, TValue>;
+        using reference = typename rows_template::reference;
+        using const_reference = typename rows_template::const_reference;
+
+        soa_map() = default;
+
+        [[maybe_unused]] [[nodiscard]] std::size_t size() const noexcept {
+            return m_rows.size();
+        }
+
+        [[maybe_unused]] [[nodiscard]] std::size_t capacity() const noexcept {
+            return m_rows.capacity();
+        }
+
+        [[maybe_unused]] void reserve(std::size_t new_capacity) {
+            m_rows.reserve(new_capacity);
+        }
+
+        // Only a const view, reordering the rows would break the index
+        [[maybe_unused]] const rows_template& raw() const noexcept {
+            return m_rows;
+        }
+
+        // All keys in one contiguous block, in the same order as values()
+        [[maybe_unused]] std::span<const first_type> keys() const noexcept {
+            return m_rows.template column<0>();
+        }
+
+        // The values can be changed in place, the keys can not
+        [[maybe_unused]] std::span<second_type> values() noexcept {
+            return m_rows.template column<1>();
+        }
+
+        [[maybe_unused]] std::span<const second_type> values() const noexcept {
+            return m_rows.template column<1>();
+        }
+
+        // Returns a pointer to the value of key, or nullptr if the key is not in the map.
+        // Like mc::map, find/contains/erase_key take any key type mc::hash<TKey> hashes transparently
+        template<typename Key = TKey> requires lookup_key<Key, TKey>
+        [[maybe_unused]] second_pointer find(const Key& key) {
+            std::size_t position = m_index.find(key, key_at());
+            return position == NOT_FOUND ? nullptr : &values()[position];
+        }
+
+        template<typename Key = TKey> requires lookup_key<Key, TKey>
+        [[maybe_unused]] const second_type* find(const Key& key) const {
+            std::size_t position = m_index.find(key, key_at());
+            return position == NOT_FOUND ? nullptr : &values()[position];
+        }
+
+        template<typename Key = TKey> requires lookup_key<Key, TKey>
+        [[maybe_unused]] [[nodiscard]] bool contains(const Key& key) const {
+            return m_index.find(key, key_at()) != NOT_FOUND;
+        }
+
+        // Adds the pair only if the key is not in the map yet, the value is not touched otherwise.
+        // Returns a pointer to the value of key and whether it was inserted
+        template <typename... Args>
+        [[maybe_unused]] mc::pair<second_pointer, bool> try_emplace(first_const_reference key, Args&&... args) {
+            std::size_t position = m_index.find(key, key_at());
+
+            if (position != NOT_FOUND) {
+                return {&values()[position], false};
+            }
+
+            return {append(key, second_type(std::forward<Args>(args)...)), true};
+        }
+
+        // Adds the pair if the key is not in the map yet, overwrites the value otherwise.
+        // Returns a pointer to the value of key and whether it was inserted
+        [[maybe_unused]] mc::pair<second_pointer, bool> insert_or_assign(first_const_reference key, second_type value) {
+            std::size_t position = m_index.find(key, key_at());
+
+            if (position != NOT_FOUND) {
+                values()[position] = std::move(value);
+                return {&values()[position], false};
+            }
+
+            return {append(key, std::move(value)), true};
+        }
+
+        // Removes the pair with this key and returns how many pairs were removed (0 or 1).
+        // The last pair is moved into the gap, so this does not keep the order of the pairs
+        template<typename Key = TKey> requires lookup_key<Key, TKey>
+        [[maybe_unused]] std::size_t erase_key(const Key& key) {
+            std::size_t position = m_index.find(key, key_at());
+
+            if (position == NOT_FOUND) {
+                return 0;
+            }
+
+            m_index.erase_swap(position, size() - 1, key_at());
+            m_rows.erase_unordered(position);
+            return 1;
+        }
+
+        [[maybe_unused]] void erase() {
+            m_rows.erase();
+            m_index.clear();
+        }
+
+        // Sorts the pairs by key, only the key column is compared
+        [[maybe_unused]] void sort() {
+            m_rows.template sort_by<0>();
+            m_index.rebuild(size(), key_at(), size() * 2);
+        }
+
+        // Positional access, the key should not be changed through this
+        [[maybe_unused]] reference operator[](std::size_t index) {
+            return m_rows[index];
+        }
+
+        [[maybe_unused]] const_reference operator[](std::size_t index) const {
+            return m_rows[index];
+        }
+
+        auto begin() const noexcept {
+            return m_rows.begin();
+        }
+
+        auto end() const noexcept {
+            return m_rows.end();
+        }
+
+    private:
+        using index_template = detail::hash_index<TKey>;
+
+        static constexpr std::size_t NOT_FOUND{index_template::NOT_FOUND};
+
+        // The index reads the keys straight out of the key column
+        auto key_at() const {
+            return [this](std::size_t position) -> first_const_reference {
+                return m_rows.template get<0>(position);
+            };
+        }
+
+        second_pointer append(first_const_reference key, second_type value) {
+            m_rows.push_back(key, std::move(value));
+            m_index.insert(size() - 1, size(), key_at());
+            return &values()[size() - 1];
+        }
+
+        rows_template m_rows;
+        index_template m_index;
+    };
+
+}
+
+#endif //APC_LIBRARY_SOA_MAP_H
@@ -0,0 +1,315 @@
+//
+// Created by Camiel Verdult on 17/10/2026.
+//
+
+#ifndef APC_LIBRARY_SOA_VECTOR_H
+#define APC_LIBRARY_SOA_VECTOR_H
+
+#include "pair.h"
+#include "sort.h"
+#include "vector.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace mc {
+
+    // A vector of records that stores every field in its own mc::vector (structure of arrays).
+    // A scan over one field only pulls that field into the cache instead of whole records, and a column of
+    // numbers can be handed to SIMD code as one std::span.
+    //
+    // Rows are accessed through proxies: operator[] returns a std::tuple of references to the fields of that row,
+    // which works with structured bindings: auto [id, price] = soa[i];
+    // Every function that adds, removes or reorders rows does it to all columns, so they always stay aligned
+    template <typename... Fields>
+    class soa_vector {
+        static_assert(sizeof...(Fields) > 0, "a soa_vector needs at least one field");
+
+    public:
+        using value_type = std::tuple<Fields...>;
+        using reference = std::tuple<Fields&...>;
+        using const_reference = std::tuple<const Fields&...>;
+
+        template <std::size_t I>
+        using field_type = std::tuple_element_t<I, value_type>;
+
+        static constexpr std::size_t FIELD_COUNT{sizeof...(Fields)};
+
+        // Walks the rows and yields a proxy for every row.
+        // A proxy is not a real reference, so for the classic iterator requirements this is only an input iterator.
+        // The C++20 concepts do allow proxies, there it is a forward iterator and works with the std::ranges algorithms
+        template <bool Const>
+        class basic_iterator {
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using iterator_concept = std::forward_iterator_tag;
+            using value_type = soa_vector::value_type;
+            using difference_type = std::ptrdiff_t;
+            using reference = std::conditional_t<Const, soa_vector::const_reference, soa_vector::reference>;
+
+            using owner_pointer = std::conditional_t<Const, const soa_vector*, soa_vector*>;
+
+            basic_iterator() = default;
+            basic_iterator(owner_pointer owner, std::size_t index) : m_owner{owner}, m_index{index} {}
+
+            reference operator*() const {
+                return (*m_owner)[m_index];
+            }
+
+            basic_iterator& operator++() {
+                m_index++;
+                return *this;
+            }
+
+            basic_iterator operator++(int) {
+                basic_iterator previous = *this;
+                m_index++;
+                return previous;
+            }
+
+            bool operator==(const basic_iterator& other) const {
+                return m_index == other.m_index;
+            }
+
+        private:
+            owner_pointer m_owner{nullptr};
+            std::size_t m_index{0};
+        };
+
+        using iterator = basic_iterator<false>;
+        using const_iterator = basic_iterator<true>;
+
+        soa_vector() = default;
+
+        [[maybe_unused]] [[nodiscard]] std::size_t size() const noexcept {
+            return std::get<0>(m_columns).size();
+        }
+
+        [[maybe_unused]] [[nodiscard]] std::size_t capacity() const noexcept {
+            return std::get<0>(m_columns).capacity();
+        }
+
+        // Adds one row, every field goes to the end of its column
+        [[maybe_unused]] void push_back(Fields... fields) {
+            // Make room in every column first, so a failing allocation can not leave the columns uneven
+            reserve_for(size() + 1);
+            push_back_columns(std::index_sequence_for<Fields...>{}, fields...);
+        }
+
+        [[maybe_unused]] void push_back(value_type row) {
+            std::apply([this](auto&... fields) {
+                push_back(std::move(fields)...);
+            }, row);
+        }
+
+        [[maybe_unused]] void pop_back() {
+            std::apply([](auto&... columns) {
+                (columns.pop_back(), ...);
+            }, m_columns);
+        }
+
+        // Removes the row at index, the rows after it shift one place
+        [[maybe_unused]] void erase(std::size_t index) {
+            if (index >= size()) {
+                // Index is out of bounds
+                throw "soa_vector_error: erase(i) is out of bounds\n";
+            }
+
+            std::apply([index](auto&... columns) {
+                (columns.erase(index), ...);
+            }, m_columns);
+        }
+
+        // Removes the row at index in O(1) by moving the last row into its place, this does not keep the order
+        [[maybe_unused]] void erase_unordered(std::size_t index) {
+            if (index >= size()) {
+                // Index is out of bounds
+                throw "soa_vector_error: erase_unordered(i) is out of bounds\n";
+            }
+
+            std::size_t last = size() - 1;
+
+            if (index != last) {
+                std::apply([index, last](auto&... columns) {
+                    ((columns[index] = std::move(columns[last])), ...);
+                }, m_columns);
+            }
+
+            pop_back();
+        }
+
+        // Removes all rows
+        [[maybe_unused]] void erase() {
+            std::apply([](auto&... columns) {
+                (columns.erase(), ...);
+            }, m_columns);
+        }
+
+        [[maybe_unused]] void reserve(std::size_t new_capacity) {
+            std::apply([new_capacity](auto&... columns) {
+                (columns.reserve(new_capacity), ...);
+            }, m_columns);
+        }
+
+        // Returns references to all fields of the row at index
+        [[maybe_unused]] reference operator[](std::size_t index) {
+            return std::apply([index](auto&... columns) {
+                return reference(columns[index]...);
+            }, m_columns);
+        }
+
+        [[maybe_unused]] const_reference operator[](std::size_t index) const {
+            return std::apply([index](const auto&... columns) {
+                return const_reference(columns[index]...);
+            }, m_columns);
+        }
+
+        [[maybe_unused]] reference at(std::size_t index) {
+            if (index >= size()) {
+                // Index is out of bounds
+                throw "soa_vector_error: at(i) is out of bounds\n";
+            }
+
+            return (*this)[index];
+        }
+
+        [[maybe_unused]] const_reference at(std::size_t index) const {
+            if (index >= size()) {
+                // Index is out of bounds
+                throw "soa_vector_error: at(i) is out of bounds\n";
+            }
+
+            return (*this)[index];
+        }
+
+        // Returns field I of the row at index
+        template <std::size_t I>
+        [[maybe_unused]] field_type<I>& get(std::size_t index) {
+            return std::get<I>(m_columns)[index];
+        }
+
+        template <std::size_t I>
+        [[maybe_unused]] const field_type<I>& get(std::size_t index) const {
+            return std::get<I>(m_columns)[index];
+        }
+
+        // Returns all values of field I as one contiguous span, the span is invalidated by adding rows
+        template <std::size_t I>
+        [[maybe_unused]] std::span<field_type<I>> column() noexcept {
+            auto& column = std::get<I>(m_columns);
+            return {column.begin(), column.size()};
+        }
+
+        template <std::size_t I>
+        [[maybe_unused]] std::span<const field_type<I>> column() const noexcept {
+            const auto& column = std::get<I>(m_columns);
+            return {column.begin(), column.size()};
+        }
+
+        // Sorts the rows by field I, rows with equal values keep their order.
+        // Only column I is compared, the other columns are then moved once into the sorted order
+        template <std::size_t I>
+        [[maybe_unused]] void sort_by() {
+            apply_permutation(sorted_order<I>());
+        }
+
+        iterator begin() noexcept {
+            return {this, 0};
+        }
+
+        iterator end() noexcept {
+            return {this, size()};
+        }
+
+        const_iterator begin() const noexcept {
+            return {this, 0};
+        }
+
+        const_iterator end() const noexcept {
+            return {this, size()};
+        }
+
+    private:
+        // Moves every field to the end of its column. If moving one of them throws, the fields that already went
+        // into the columns before it are taken out again, so all columns keep the same length
+        template <std::size_t... I>
+        void push_back_columns(std::index_sequence<I...>, Fields&... fields) {
+            std::size_t pushed = 0;
+
+            try {
+                ((std::get<I>(m_columns).push_back(std::move(fields)), pushed++), ...);
+            } catch (...) {
+                ((I < pushed ? std::get<I>(m_columns).pop_back() : void()), ...);
+                throw;
+            }
+        }
+
+        void reserve_for(std::size_t count) {
+            if (count > capacity()) {
+                reserve(std::max(count, capacity() * 2));
+            }
+        }
+
+        // Returns the row indices in the order that sorts column I
+        template <std::size_t I>
+        mc::vector<std::size_t> sorted_order() const {
+            using key_type = field_type<I>;
+            const auto& keys = std::get<I>(m_columns);
+
+            mc::vector<std::size_t> order(size());
+
+            if constexpr (mc::sorting::is_radix_key_v<key_type>) {
+                // Integer keys: sort (key, row) pairs so mc::sorting can use its radix sort
+                mc::vector<mc::pair<key_type, std::size_t>> keyed(size());
+
+                for (std::size_t row = 0; row < size(); row++) {
+                    keyed.push_back({keys[row], row});
+                }
+
+                mc::sorting::sort_by_key(keyed.begin(), keyed.end());
+
+                for (auto& entry : keyed) {
+                    order.push_back(entry.second);
+                }
+            } else {
+                for (std::size_t row = 0; row < size(); row++) {
+                    order.push_back(row);
+                }
+
+                std::stable_sort(order.begin(), order.end(), [&keys](std::size_t a, std::size_t b) {
+                    return keys[a] < keys[b];
+                });
+            }
+
+            return order;
+        }
+
+        // Rebuilds every column in the given row order
+        void apply_permutation(const mc::vector<std::size_t>& order) {
+            std::apply([&order](auto&... columns) {
+                (permute(columns, order), ...);
+            }, m_columns);
+        }
+
+        template <typename Column>
+        static void permute(Column& column, const mc::vector<std::size_t>& order) {
+            Column sorted(column.capacity());
+
+            for (std::size_t row : order) {
+                sorted.push_back(std::move(column[row]));
+            }
+
+            column = std::move(sorted);
+        }
+
+        std::tuple<mc::vector<Fields>...> m_columns;
+    };
+
+}
+
+#endif //APC_LIBRARY_SOA_VECTOR_H
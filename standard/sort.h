@@ -0,0 +1,235 @@
+//
+// Created by Camiel Verdult on 17/10/2026.
+//
+
+#ifndef APC_LIBRARY_SORT_H
+#define APC_LIBRARY_SORT_H
+
+#include "pair.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// The sort engine behind mc::vector::sort() and mc::map::sort().
+// It picks a strategy based on the element type and the amount of elements:
+//  - integers and pairs of integers are sorted with an LSD radix sort, which is O(n) instead of O(n log n)
+//  - large ranges of anything else are sorted by a merge sort that runs on all cores
+//  - small ranges simply use std::sort, threads and radix passes only pay off once there is enough work
+namespace mc::sorting {
+
+    // Below this many elements the radix sort is slower than std::sort because of its fixed cost per pass
+    inline constexpr std::size_t RADIX_THRESHOLD{256};
+
+    // Below this many elements starting threads costs more than it saves
+    inline constexpr std::size_t PARALLEL_THRESHOLD{1 << 16};
+
+    // Integers we can radix sort on, bool is integral as well but there is nothing to gain there
+    template <typename T>
+    inline constexpr bool is_radix_key_v = std::is_integral_v<T> and not std::is_same_v<T, bool>;
+
+    // Maps an integer to an unsigned integer with the same ordering, negative numbers get their sign bit flipped
+    template <typename T>
+    constexpr std::make_unsigned_t<T> radix_key(T value) noexcept {
+        using unsigned_type = std::make_unsigned_t<T>;
+
+        if constexpr (std::is_signed_v<T>) {
+            return static_cast<unsigned_type>(value) ^ (unsigned_type{1} << (sizeof(T) * CHAR_BIT - 1));
+        } else {
+            return value;
+        }
+    }
+
+    // Stable LSD radix sort on one byte at a time of the key that key_of returns.
+    // The elements are moved around with memcpy, so they have to be trivially copyable
+    template <typename T, typename KeyOf>
+    void radix_sort(T* first, T* last, KeyOf key_of) {
+        static_assert(std::is_trivially_copyable_v<T>, "radix_sort moves elements by their bytes");
+
+        using key_type = decltype(radix_key(key_of(*first)));
+
+        const auto count = static_cast<std::size_t>(last - first);
+
+        // Scratch space, the elements are trivially copyable so we only need the raw storage
+        auto scratch = std::make_unique_for_overwrite<std::byte[]>(count * sizeof(T));
+        T* from = first;
+        T* to = reinterpret_cast<T*>(scratch.get());
+
+        for (std::size_t shift = 0; shift < sizeof(key_type) * CHAR_BIT; shift += CHAR_BIT) {
+            std::size_t offsets[256]{};
+
+            for (T* it = from; it != from + count; ++it) {
+                offsets[(radix_key(key_of(*it)) >> shift) & 0xFF]++;
+            }
+
+            // A pass where every element has the same byte would not change anything
+            if (std::find(std::begin(offsets), std::end(offsets), count) != std::end(offsets)) {
+                continue;
+            }
+
+            // Turn the counts into the start offset of every bucket
+            std::size_t total = 0;
+            for (auto& offset : offsets) {
+                std::size_t bucket = offset;
+                offset = total;
+                total += bucket;
+            }
+
+            for (T* it = from; it != from + count; ++it) {
+                std::memcpy(static_cast<void*>(to + offsets[(radix_key(key_of(*it)) >> shift) & 0xFF]++), static_cast<const void*>(it), sizeof(T));
+            }
+
+            std::swap(from, to);
+        }
+
+        // After an odd amount of passes the sorted elements are in the scratch space
+        if (from != first) {
+            std::memcpy(static_cast<void*>(first), static_cast<const void*>(from), count * sizeof(T));
+        }
+    }
+
+    // Sorts the range in chunks on all cores, then merges neighbouring chunks (also in parallel) until one is left.
+    // std::stable_sort and std::inplace_merge are both stable, so with stable set the whole sort is too
+    template <typename T, typename Compare>
+    void parallel_merge_sort(T* first, T* last, Compare compare, bool stable) {
+        const auto count = static_cast<std::size_t>(last - first);
+
+        // Use a power of two amount of chunks so every merge round halves them evenly
+        std::size_t chunks = 1;
+        while (chunks * 2 <= std::max(1u, std::thread::hardware_concurrency()) and count / (chunks * 2) >= PARALLEL_THRESHOLD / 2) {
+            chunks *= 2;
+        }
+
+        if (chunks == 1) {
+            stable ? std::stable_sort(first, last, compare) : std::sort(first, last, compare);
+            return;
+        }
+
+        std::vector<T*> bounds;
+        for (std::size_t i = 0; i <= chunks; i++) {
+            bounds.push_back(first + count * i / chunks);
+        }
+
+        std::vector<std::thread> threads;
+        threads.reserve(chunks);
+
+        // An exception that escapes a std::thread calls std::terminate, so every worker catches its own
+        // and the first one is thrown again here once all threads have been joined
+        std::vector<std::exception_ptr> errors(chunks);
+
+        // When no thread can be started the work runs on this thread instead, so the threads that did start
+        // are still joined before anything leaves this function, they use the locals on this stack
+        auto spawn = [&threads](auto work) {
+            try {
+                threads.emplace_back(work);
+            } catch (...) {
+                work();
+            }
+        };
+
+        auto join_all = [&threads, &errors] {
+            for (auto& thread : threads) {
+                thread.join();
+            }
+
+            for (auto& error : errors) {
+                if (error) {
+                    std::rethrow_exception(error);
+                }
+            }
+        };
+
+        for (std::size_t i = 0; i < chunks; i++) {
+            spawn([&bounds, &compare, &errors, stable, i] {
+                try {
+                    stable ? std::stable_sort(bounds[i], bounds[i + 1], compare) : std::sort(bounds[i], bounds[i + 1], compare);
+                } catch (...) {
+                    errors[i] = std::current_exception();
+                }
+            });
+        }
+
+        join_all();
+
+        // Every round merges chunk i with chunk i + width
+        for (std::size_t width = 1; width < chunks; width *= 2) {
+            threads.clear();
+
+            for (std::size_t i = 0; i < chunks; i += width * 2) {
+                spawn([&bounds, &compare, &errors, width, i] {
+                    try {
+                        std::inplace_merge(bounds[i], bounds[i + width], bounds[i + width * 2], compare);
+                    } catch (...) {
+                        errors[i] = std::current_exception();
+                    }
+                });
+            }
+
+            join_all();
+        }
+    }
+
+    // Sorts with operator< of T, this is what mc::vector::sort() uses
+    template <typename T>
+    void sort(T* first, T* last) {
+        const auto count = static_cast<std::size_t>(last - first);
+        auto less = [](const T& a, const T& b) { return a < b; };
+
+        if constexpr (is_radix_key_v<T>) {
+            if (count >= RADIX_THRESHOLD) {
+                radix_sort(first, last, [](T value) { return value; });
+                return;
+            }
+        } else if constexpr (requires { typename T::first_type; typename T::second_type; }) {
+            // mc::pair compares first and then second, a radix sort on second followed by one on first does the same
+            using first_type = typename T::first_type;
+            using second_type = typename T::second_type;
+
+            if constexpr (std::is_same_v<T, mc::pair<first_type, second_type>> and std::is_trivially_copyable_v<T>
+                          and is_radix_key_v<first_type> and is_radix_key_v<second_type>) {
+                if (count >= RADIX_THRESHOLD) {
+                    radix_sort(first, last, [](const T& entry) { return entry.second; });
+                    radix_sort(first, last, [](const T& entry) { return entry.first; });
+                    return;
+                }
+            }
+        }
+
+        if (count >= PARALLEL_THRESHOLD) {
+            parallel_merge_sort(first, last, less, false);
+        } else {
+            std::sort(first, last, less);
+        }
+    }
+
+    // Sorts pairs by their key only and keeps pairs with the same key in their current order,
+    // this is what mc::map::sort() uses
+    template <typename TKey, typename TValue>
+    void sort_by_key(mc::pair<TKey, TValue>* first, mc::pair<TKey, TValue>* last) {
+        using pair_type = mc::pair<TKey, TValue>;
+
+        const auto count = static_cast<std::size_t>(last - first);
+        auto key_less = [](const pair_type& a, const pair_type& b) { return a.first < b.first; };
+
+        if constexpr (is_radix_key_v<TKey> and std::is_trivially_copyable_v<pair_type>) {
+            if (count >= RADIX_THRESHOLD) {
+                radix_sort(first, last, [](const pair_type& entry) { return entry.first; });
+                return;
+            }
+        }
+
+        if (count >= PARALLEL_THRESHOLD) {
+            parallel_merge_sort(first, last, key_less, true);
+        } else {
+            std::stable_sort(first, last, key_less);
+        }
+    }
+}
+
+#endif //APC_LIBRARY_SORT_H
@@ -0,0 +1,118 @@
+//
+// Created by Camiel Verdult on 17/10/2026.
+//
+
+#ifndef APC_LIBRARY_STATIC_MAP_H
+#define APC_LIBRARY_STATIC_MAP_H
+
+#include "pair.h"
+
+#include <algorithm>
+#include <cstddef>
+
+namespace mc {
+
+    // A map with a fixed set of keys that is built at compile time, for things like opcode tables and
+    // enum-to-string mappings that never change:
+    //
+    //     constexpr auto opcodes = mc::make_static_map<char, std::string_view>({{'a', "add"}, {'s', "sub"}});
+    //     static_assert(opcodes.at('s') == "sub");
+    //
+    // The pairs are sorted by key while compiling and stored inline, so there is no heap and nothing runs at startup.
+    // A lookup is a branchless binary search: the number of steps only depends on N, so for a constant N the compiler
+    // unrolls it into log2(N) compares and conditional moves without mispredicted branches.
+    // Keys and values have to be usable in constant expressions (numbers, enums, std::string_view, ...)
+    template<typename TKey, typename TValue, std::size_t N>
+    class static_map {
+        static_assert(N > 0, "a static_map needs at least one pair");
+
+    public:
+
+        using first_type = TKey;
+        using first_const_reference = const TKey&;
+
+        using second_type = TValue;
+
+        using pair_template = mc::pair<TKey, TValue>;
+        using value_type = pair_template;
+        using const_iterator = const pair_template*;
+
+        // Sorts the pairs by key, a key that is in there twice fails to compile when this runs at compile time
+        constexpr explicit static_map(const pair_template (&entries)[N]) : m_pairs{} {
+            std::copy(entries, entries + N, m_pairs);
+
+            std::sort(m_pairs, m_pairs + N, [](const pair_template& a, const pair_template& b) {
+                return a.first < b.first;
+            });
+
+            for (std::size_t i = 1; i < N; i++) {
+                if (not (m_pairs[i - 1].first < m_pairs[i].first)) {
+                    // Both pairs would have the same key
+                    throw "static_map_error: duplicate key\n";
+                }
+            }
+        }
+
+        [[maybe_unused]] [[nodiscard]] constexpr std::size_t size() const noexcept {
+            return N;
+        }
+
+        // Returns a pointer to the pair with this key, or end() if the key is not in the map
+        [[maybe_unused]] constexpr const pair_template* find(first_const_reference key) const {
+            const pair_template* found = m_pairs + lower_bound_index(key);
+            return found != end() and not (key < found->first) ? found : end();
+        }
+
+        [[maybe_unused]] [[nodiscard]] constexpr bool contains(first_const_reference key) const {
+            return find(key) != end();
+        }
+
+        [[maybe_unused]] constexpr const second_type& at(first_const_reference key) const {
+            const pair_template* found = find(key);
+
+            if (found == end()) {
+                // Key is not in the map
+                throw "static_map_error: at(key) key is not in the map\n";
+            }
+
+            return found->second;
+        }
+
+        // The pairs in key order
+        constexpr const pair_template* begin() const noexcept {
+            return m_pairs;
+        }
+
+        constexpr const pair_template* end() const noexcept {
+            return m_pairs + N;
+        }
+
+    private:
+        // The index of the first pair with a key that is not less than key, or N.
+        // Every step halves the range with a conditional move instead of a branch
+        constexpr std::size_t lower_bound_index(first_const_reference key) const {
+            const pair_template* base = m_pairs;
+            std::size_t length = N;
+
+            while (length > 1) {
+                std::size_t half = length / 2;
+                base = base[half - 1].first < key ? base + half : base;
+                length -= half;
+            }
+
+            return static_cast<std::size_t>(base - m_pairs) + (base->first < key ? 1 : 0);
+        }
+
+        pair_template m_pairs[N];
+    };
+
+    // Builds a static_map and counts the pairs for you, TKey and TValue have to be given:
+    // constexpr auto colors = mc::make_static_map<int, std::string_view>({{0, "red"}, {1, "green"}});
+    template<typename TKey, typename TValue, std::size_t N>
+    [[maybe_unused]] constexpr static_map<TKey, TValue, N> make_static_map(const mc::pair<TKey, TValue> (&entries)[N]) {
+        return static_map<TKey, TValue, N>(entries);
+    }
+
+}
+
+#endif //APC_LIBRARY_STATIC_MAP_H
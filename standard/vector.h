@@ -5,13 +5,94 @@
 #ifndef APC_LIBRARY_VECTOR_H
 #define APC_LIBRARY_VECTOR_H
 
+#include "instrumentation.h"
+#include "simd.h"
+#include "sort.h"
+
 #include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
 #include <initializer_list>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 namespace mc {
 
+    // Growth policies decide how much capacity mc::vector allocates once it runs out of room.
+    // A policy has a single static next_capacity(capacity, required, element_size) that returns a capacity
+    // of at least required, element_size is sizeof(T) for policies that care about bytes instead of elements
+    namespace growth {
+
+        // Multiplies the capacity by Numerator / Denominator until there is room for more than required elements
+        template <std::size_t Numerator, std::size_t Denominator = 1>
+        struct geometric {
+            static_assert(Numerator > Denominator, "a growth policy has to grow");
+
+            static constexpr std::size_t next_capacity(std::size_t capacity, std::size_t required, std::size_t element_size) noexcept {
+                // The most elements whose bytes still fit in a std::size_t, growing past it would wrap around
+                std::size_t limit = std::numeric_limits<std::size_t>::max() / std::max<std::size_t>(element_size, 1);
+
+                // A vector created with capacity 0 would never grow otherwise
+                std::size_t new_capacity = std::max<std::size_t>(capacity, 1);
+
+                // Small capacities times 1.5 would round down to the same capacity, so always grow by at least one
+                while (new_capacity <= required) {
+                    if (new_capacity > limit / Numerator) {
+                        // Another step would overflow, take what is left. The vector rejects anything above its max_size()
+                        return std::max(limit, required);
+                    }
+
+                    new_capacity = std::max(new_capacity * Numerator / Denominator, new_capacity + 1);
+                }
+
+                return new_capacity;
+            }
+        };
+
+        using doubling = geometric<2>;
+        using one_and_a_half = geometric<3, 2>;
+
+        // Grows like Small, but once the buffer is at least a page it is rounded up to whole pages.
+        // Large buffers come straight from mmap anyway, so the rest of the last page would be wasted otherwise
+        template <std::size_t PageSize = 4096, typename Small = one_and_a_half>
+        struct page_granular {
+            static constexpr std::size_t next_capacity(std::size_t capacity, std::size_t required, std::size_t element_size) noexcept {
+                std::size_t new_capacity = Small::next_capacity(capacity, required, element_size);
+                std::size_t bytes = new_capacity * element_size;
+
+                // Rounding up a buffer this close to the end of the address space would overflow
+                if (bytes < PageSize or bytes > std::numeric_limits<std::size_t>::max() - PageSize) {
+                    return new_capacity;
+                }
+
+                std::size_t pages = (bytes + PageSize - 1) / PageSize;
+                return pages * PageSize / element_size;
+            }
+        };
+    }
+
+    // A type is trivially relocatable if moving it to a new address and forgetting the old object is the same
+    // as copying its bytes. mc::vector then moves its elements with memmove/realloc instead of one by one.
+    // Trivially copyable types always are, specialise this for types that are too (e.g. most std::unique_ptr)
     template <typename T>
+    struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+    template <typename T>
+    inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+    // Allocator can be any std::allocator compatible allocator, the elements are constructed and destroyed through it.
+    // See mc::pmr::vector for a vector that gets its memory from a std::pmr::memory_resource
+    template <typename T, typename GrowthPolicy = growth::doubling, typename Allocator = std::allocator<T>>
     class vector {
+        using allocator_traits = std::allocator_traits<Allocator>;
+
+        static_assert(std::is_same_v<typename allocator_traits::pointer, T*>, "fancy pointers are not supported");
 
     public:
         // It’s a good idea to define those. Others can then easily probe a vector object in generic code.
@@ -20,10 +101,20 @@ namespace mc {
         using const_pointer = const T*;
         using reference = T&;
         using const_reference = const T&;
+        using growth_policy = GrowthPolicy;
+        using allocator_type = Allocator;
+
+        // The iterators are plain pointers, which makes a vector a std::ranges::contiguous_range
+        using iterator = T*;
+        using const_iterator = const T*;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
 
         // Normal constructor
-        explicit vector(std::size_t capacity):
-                m_data{ new T[capacity] },
+        // This only allocates raw storage, elements are constructed once they are pushed back
+        explicit vector(std::size_t capacity, const Allocator& allocator = Allocator()):
+                m_allocator{ allocator },
+                m_data{ allocate(capacity) },
                 m_cap{ capacity },
                 m_sz{ 0 } {}
 
@@ -32,29 +123,58 @@ namespace mc {
         // Default constructor
         vector(): vector(DEFAULT_CAP) {};
 
+        // Default constructor with a specific allocator
+        explicit vector(const Allocator& allocator): vector(DEFAULT_CAP, allocator) {};
+
         // Initializer list constructor
-        vector(std::initializer_list<T> list) : vector(DEFAULT_CAP) {
+        vector(std::initializer_list<T> list, const Allocator& allocator = Allocator()) : vector(DEFAULT_CAP, allocator) {
             for (auto& entry : list) {
                 push_back(entry); // This will update size while pushing back entries
             }
         }
 
         // Copy constructor
+        // The allocator decides itself whether a copy shares it, std::pmr allocators for example go back to the default resource
         vector(const vector& other):
-            m_data{ new T[other.capacity()] },
+            vector(other, allocator_traits::select_on_container_copy_construction(other.m_allocator)) {}
+
+        // Copy constructor that puts the copy in memory from allocator
+        vector(const vector& other, const Allocator& allocator):
+            m_allocator{ allocator },
+            m_data{ allocate(other.capacity()) },
             m_cap{ other.capacity() },
-            m_sz{ other.size() } {
+            m_sz{ 0 } {
             // copy over data from other vector
 
-            // use std::uninitialized_copy instead of std::copy because we are dealing with allocated memory
+            // construct the copies in place instead of using std::copy because we are dealing with allocated memory
             // thanks to @zaldawid
-            std::uninitialized_copy(other.begin(), other.end(), m_data);
+            try {
+                copy_construct(other.begin(), other.size(), m_data);
+            } catch (...) {
+                // The destructor does not run if a constructor throws
+                deallocate(m_data, m_cap);
+                throw;
+            }
+
+            m_sz = other.size();
         }
 
+        // Move constructor, this takes over the buffer of other and leaves it empty without any capacity
+        vector(vector&& other) noexcept:
+            m_allocator{ std::move(other.m_allocator) },
+            m_data{ std::exchange(other.m_data, nullptr) },
+            m_cap{ std::exchange(other.m_cap, 0) },
+            m_sz{ std::exchange(other.m_sz, 0) } {}
+
         ~vector(){
             // thanks to @zaldawid
-            std::destroy_n(m_data, m_sz);
-            delete[] m_data;
+            // Only the first m_sz slots hold live elements, the rest is raw storage
+            if (m_data != nullptr) {
+                instrumentation::record<vector>(instrumentation::event_kind::release, (m_cap - m_sz) * sizeof(T), m_cap, m_sz);
+            }
+
+            destroy(m_data, m_sz);
+            deallocate(m_data, m_cap);
         }
 
         [[maybe_unused]] [[nodiscard]] std::size_t capacity() const noexcept {
@@ -65,6 +185,19 @@ namespace mc {
             return m_sz;
         }
 
+        // The most elements a vector can ever hold, asking for more capacity than this throws
+        [[maybe_unused]] [[nodiscard]] std::size_t max_size() const noexcept {
+            if constexpr (REALLOCATABLE) {
+                return std::numeric_limits<std::size_t>::max() / sizeof(T);
+            } else {
+                return allocator_traits::max_size(m_allocator);
+            }
+        }
+
+        [[maybe_unused]] [[nodiscard]] allocator_type get_allocator() const noexcept {
+            return m_allocator;
+        }
+
         // Copy assignment operator
         [[maybe_unused]] vector& operator=(const vector& other) {
 
@@ -73,19 +206,44 @@ namespace mc {
                 return *this;
             }
 
-            if (other.capacity() > m_cap) { // using .size() for compare might be a bug
-                // We need to delete our previous array because it is too
-                // small to fit the other.raw() data and create a new array
-                // which will fit the other capacity just fine
+            if constexpr (allocator_traits::propagate_on_container_copy_assignment::value) {
+                if (m_allocator != other.m_allocator) {
+                    // Our buffer has to go back to the allocator it came from before we take over the one of other
+                    destroy(m_data, m_sz);
+                    deallocate(m_data, m_cap);
 
-                std::destroy_n(m_data, m_sz);
-                delete[] m_data;
+                    m_data = nullptr;
+                    m_cap = 0;
+                    m_sz = 0;
+                }
 
-                m_data = new T[other.capacity()];
+                m_allocator = other.m_allocator;
             }
 
-            // copy over data from other
-            std::copy(other.begin(), other.end(), m_data);
+            if (other.capacity() != m_cap) {
+                // We copy the capacity of other as well, so we need a new buffer of that exact size.
+                // Construct the copies first so we are left untouched if a copy constructor throws
+                pointer replacement = allocate(other.capacity());
+
+                try {
+                    copy_construct(other.begin(), other.size(), replacement);
+                } catch (...) {
+                    deallocate(replacement, other.capacity());
+                    throw;
+                }
+
+                destroy(m_data, m_sz);
+                deallocate(m_data, m_cap);
+
+                m_data = replacement;
+            } else {
+                // Same buffer size, we can reuse our storage. Elements past other.size() have to be destroyed
+                // because the slots after m_sz are treated as raw memory
+                destroy(m_data, m_sz);
+                m_sz = 0;
+
+                copy_construct(other.begin(), other.size(), m_data);
+            }
 
             // Update member variables
             m_cap = other.capacity();
@@ -94,6 +252,43 @@ namespace mc {
             return *this;
         }
 
+        // Move assignment operator
+        // The buffer of other can only be taken over if our allocator is allowed to free it afterwards
+        [[maybe_unused]] vector& operator=(vector&& other) noexcept(allocator_traits::propagate_on_container_move_assignment::value
+                                                                   or allocator_traits::is_always_equal::value) {
+            if (this == &other) {
+                return *this;
+            }
+
+            if constexpr (not allocator_traits::propagate_on_container_move_assignment::value
+                          and not allocator_traits::is_always_equal::value) {
+                if (m_allocator != other.m_allocator) {
+                    // Memory of a different allocator, move the elements over one by one into our own memory instead
+                    clear();
+                    reserve(other.size());
+
+                    move_construct(other.m_data, other.m_sz, m_data);
+                    m_sz = other.m_sz;
+
+                    other.clear();
+                    return *this;
+                }
+            }
+
+            destroy(m_data, m_sz);
+            deallocate(m_data, m_cap);
+
+            if constexpr (allocator_traits::propagate_on_container_move_assignment::value) {
+                m_allocator = std::move(other.m_allocator);
+            }
+
+            m_data = std::exchange(other.m_data, nullptr);
+            m_cap = std::exchange(other.m_cap, 0);
+            m_sz = std::exchange(other.m_sz, 0);
+
+            return *this;
+        }
+
         [[maybe_unused]] const_pointer raw() const noexcept {
             return m_data;
         }
@@ -104,36 +299,122 @@ namespace mc {
 
         // This cannot be noexcept because you allocate memory which can throw
         // thanks @zaldawid
-        void push_back(const_reference entry) {
-            adjust_cap();
-            m_data[m_sz++] = entry;
-//            std::construct_at(m_data[m_sz], entry);
+        reference push_back(const_reference entry) {
+            return emplace_back(entry);
         }
 
-        void push_back(reference& entry) {
-            adjust_cap();
+        // Only rvalues are moved from, an lvalue is copied by the overload above
+        reference push_back(value_type&& entry) {
+            return emplace_back(std::move(entry));
+        }
+
+        // Constructs the new element in place from args and returns a reference to it
+        template <typename... Args>
+        reference emplace_back(Args&&... args) {
+            instrumentation::record_construct<vector, T, Args...>();
+
+            if (m_sz == m_cap) {
+                if constexpr (RELOCATABLE) {
+                    // args might refer to one of our own elements and realloc can move the buffer,
+                    // so build the element on the side first and copy its bytes in afterwards.
+                    // It is relocated into the buffer, so the allocator does not get to construct it
+                    staging_slot staging;
+                    pointer staged = std::construct_at(staging.get(), std::forward<Args>(args)...);
+
+                    try {
+                        reallocate(grown_capacity(m_sz + 1));
+                    } catch (...) {
+                        std::destroy_at(staged);
+                        throw;
+                    }
+
+                    relocate(staged, 1, m_data + m_sz);
+                } else {
+                    // args might refer to one of our own elements, so construct the new element
+                    // in the replacement buffer before the old elements are moved out
+                    std::size_t new_capacity = grown_capacity(m_sz + 1);
+                    instrumentation::record<vector>(instrumentation::event_kind::reallocate, 0, new_capacity, m_sz);
+
+                    pointer replacement = allocate(new_capacity);
+
+                    try {
+                        construct(replacement + m_sz, std::forward<Args>(args)...);
+                    } catch (...) {
+                        deallocate(replacement, new_capacity);
+                        throw;
+                    }
+
+                    try {
+                        move_construct(m_data, m_sz, replacement);
+                    } catch (...) {
+                        destroy(replacement + m_sz, 1);
+                        deallocate(replacement, new_capacity);
+                        throw;
+                    }
+
+                    destroy(m_data, m_sz);
+                    deallocate(m_data, m_cap);
+
+                    m_data = replacement;
+                    m_cap = new_capacity;
+                }
+            } else {
+                construct(m_data + m_sz, std::forward<Args>(args)...);
+            }
 
-            // We use std::move here
-            m_data[m_sz++] = std::move(entry);
-//            std::construct_at(m_data[m_sz], std::move(entry);
+            return m_data[m_sz++];
         }
 
-        [[maybe_unused]] void insert(const std::size_t index, const value_type entry) {
-            if (m_sz == 0 or index >= m_sz) {
-                push_back(entry);
-                return;
+        [[maybe_unused]] reference insert(const std::size_t index, const_reference entry) {
+            return emplace(index, entry);
+        }
+
+        [[maybe_unused]] reference insert(const std::size_t index, value_type&& entry) {
+            return emplace(index, std::move(entry));
+        }
+
+        // Constructs a new element from args at index, the elements from index onwards shift one place.
+        // An index past the end appends, like insert always did
+        template <typename... Args>
+        [[maybe_unused]] reference emplace(const std::size_t index, Args&&... args) {
+            if (index >= m_sz) {
+                return emplace_back(std::forward<Args>(args)...);
             }
 
-            adjust_cap();
+            instrumentation::record_construct<vector, T, Args...>();
+
+            if constexpr (RELOCATABLE) {
+                // Same as below, but the elements are shifted with a single memmove
+                staging_slot staging;
+                pointer staged = std::construct_at(staging.get(), std::forward<Args>(args)...);
+
+                try {
+                    adjust_cap();
+                } catch (...) {
+                    std::destroy_at(staged);
+                    throw;
+                }
+
+                relocate(m_data + index, m_sz - index, m_data + index + 1);
+                relocate(staged, 1, m_data + index);
+                m_sz++;
 
-            // std::copy will not work here for some reason?
-            // error: invalid type argument of unary '*' (have 'int')
-            for (size_t i = m_sz; i >= index; i--) {
-                m_data[i + 1] = m_data[i];
+                return m_data[index];
             }
 
-            m_data[index] = entry;
+            // Build the element before shifting, args might refer to an element that is about to move
+            value_type entry(std::forward<Args>(args)...);
+
+            adjust_cap();
+
+            // The slot at m_sz is raw memory, so the last element has to be move-constructed into it.
+            // The others can be shifted with move assignment because they are live objects
+            construct(m_data + m_sz, std::move(m_data[m_sz - 1]));
+            std::move_backward(m_data + index, m_data + m_sz - 1, m_data + m_sz);
             m_sz++;
+
+            m_data[index] = std::move(entry);
+            return m_data[index];
         }
 
         [[maybe_unused]] reference at(std::size_t index) {
@@ -155,7 +436,7 @@ namespace mc {
         }
 
         [[maybe_unused]] void pop_back() noexcept {
-            std::destroy_at(m_data + m_sz - 1); // std::destroy_at calls the destructor of the object pointed to by p, as if by p->~T()
+            destroy(m_data + m_sz - 1, 1); // This calls the destructor of the last element through the allocator
             --m_sz;
         }
 
@@ -169,14 +450,8 @@ namespace mc {
 
         [[maybe_unused]] void erase() {
 
-            // Destroy elements
-            std::destroy_n(m_data, m_sz);
-
-            // deallocate
-            delete[] m_data;
-
-            // reallocate
-            m_data = new T[m_cap];
+            // Destroy elements, the storage itself is kept for new entries
+            destroy(m_data, m_sz);
             m_sz = 0;
         }
 
@@ -186,15 +461,82 @@ namespace mc {
                 throw "vector_error: erase(i) is out of bounds\n";
             }
 
-            // Shift all data back
-//            std::copy(*m_data[index], end(), *m_data[index - 1]);
-
-            for (std::size_t i = index; i < m_sz - 1; i++)
-                m_data[i] = m_data[i+1];
+            if constexpr (RELOCATABLE) {
+                // Destroy the element first, after that its slot is raw memory we can memmove over
+                destroy(m_data + index, 1);
+                relocate(m_data + index + 1, m_sz - index - 1, m_data + index);
+            } else {
+                // Shift all data back and destroy the now moved-from last element
+                std::move(m_data + index + 1, m_data + m_sz, m_data + index);
+                destroy(m_data + m_sz - 1, 1);
+            }
 
             m_sz--;
         }
 
+        // Same as erase(), named like the std::vector function
+        [[maybe_unused]] void clear() noexcept {
+            destroy(m_data, m_sz);
+            m_sz = 0;
+        }
+
+        // Makes sure there is room for at least new_capacity elements, so that many push_backs do not reallocate.
+        // This allocates exactly new_capacity, the growth policy is not used here
+        [[maybe_unused]] void reserve(std::size_t new_capacity) {
+            if (new_capacity > m_cap) {
+                reallocate(new_capacity);
+            }
+        }
+
+        // Destroys the elements past new_size, or appends value-initialised elements up to new_size
+        [[maybe_unused]] void resize(std::size_t new_size) {
+            resize_with(new_size, [this](pointer slot) { construct(slot); });
+        }
+
+        // Destroys the elements past new_size, or appends copies of value up to new_size
+        [[maybe_unused]] void resize(std::size_t new_size, const_reference value) {
+            if (new_size > m_sz) {
+                instrumentation::record<vector>(instrumentation::event_kind::copy, (new_size - m_sz) * sizeof(T), 0, new_size - m_sz);
+            }
+
+            resize_with(new_size, [this, &value](pointer slot) { construct(slot, value); });
+        }
+
+        // Gives back the capacity that is not used by any element
+        [[maybe_unused]] void shrink_to_fit() {
+            if (m_cap != m_sz) {
+                reallocate(m_sz);
+            }
+        }
+
+        // Returns a pointer to the first element equal to value, or end() if there is none.
+        // This and the functions below use the SIMD kernels from simd.h for arithmetic element types
+        [[maybe_unused]] pointer find(const_reference value) {
+            return m_data + simd::find(m_data, m_sz, value);
+        }
+
+        [[maybe_unused]] const_pointer find(const_reference value) const {
+            return m_data + simd::find(m_data, m_sz, value);
+        }
+
+        [[maybe_unused]] [[nodiscard]] std::size_t count(const_reference value) const {
+            return simd::count(m_data, m_sz, value);
+        }
+
+        [[maybe_unused]] [[nodiscard]] bool contains(const_reference value) const {
+            return find(value) != end();
+        }
+
+        // Returns a pointer to the first smallest element, or end() if the vector is empty
+        [[maybe_unused]] const_pointer min_element() const {
+            return m_data + simd::min_index(m_data, m_sz);
+        }
+
+        // Returns a pointer to the first largest element, or end() if the vector is empty
+        [[maybe_unused]] const_pointer max_element() const {
+            return m_data + simd::max_index(m_data, m_sz);
+        }
+
         // Debug print function
         void debug_print(std::ostream& stream = std::cout) {
             for (std::size_t i = 0; i < m_sz; i++)
@@ -205,12 +547,11 @@ namespace mc {
 
         [[maybe_unused]] void sort() {
             /*
-             * This function will fail if typename T has no operator > function
+             * This function will fail if typename T has no operator < function
+             * See sort.h for how the sorting strategy is picked
              */
 
-            std::sort(begin(), end(), [](const_reference a, const_reference b){
-                return a < b;
-            });
+            mc::sorting::sort(begin(), end());
         }
 
         const_pointer begin() const noexcept {
@@ -220,7 +561,7 @@ namespace mc {
         const_pointer end() const noexcept {
             // This will point to the last USED element in our vector
             // To be used in std algorithm functions
-            return &m_data[m_sz]; // bug caught by @zaldawid
+            return m_data + m_sz; // bug caught by @zaldawid
         }
 
         pointer begin() noexcept {
@@ -230,46 +571,240 @@ namespace mc {
         pointer end() noexcept {
             // This will point to the last USED element in our vector
             // To be used in std algorithm functions
-            return &m_data[m_sz]; // bug caught by @zaldawid
+            return m_data + m_sz; // bug caught by @zaldawid
+        }
+
+        // Same as raw(), under the name std::span and std::ranges::data look for
+        [[maybe_unused]] pointer data() noexcept {
+            return m_data;
+        }
+
+        [[maybe_unused]] const_pointer data() const noexcept {
+            return m_data;
         }
 
     private:
-        static constexpr std::size_t GROWTH_FACTOR{2};
         void adjust_cap(std::size_t how_many_extra_elements = 1) {
 
+            if (how_many_extra_elements > max_size() - m_sz) {
+                // m_sz + how_many_extra_elements would not even fit in a std::size_t
+                throw "vector_error: size would exceed max_size()\n";
+            }
+
             std::size_t required_capacity = m_sz + how_many_extra_elements;
 
             if (required_capacity > m_cap) {
-                std::size_t new_capacity = m_cap;
+                reallocate(grown_capacity(required_capacity));
+            }
+        }
 
-                // Calculate new capacity
-                while (new_capacity <= required_capacity)
-                    new_capacity *= GROWTH_FACTOR;
+        [[nodiscard]] std::size_t grown_capacity(std::size_t required_capacity) const noexcept {
+            return GrowthPolicy::next_capacity(m_cap, required_capacity, sizeof(T));
+        }
 
-                pointer replacement = new T[new_capacity];
+        // Moves the elements to a new buffer of exactly new_capacity, which has to fit all elements
+        void reallocate(std::size_t new_capacity) {
+            check_capacity(new_capacity);
 
-                // Move over contents of array to replacement
-                std::uninitialized_move(begin(), end(), replacement);
+            instrumentation::record<vector>(instrumentation::event_kind::reallocate, 0, new_capacity, m_sz);
 
-                // Destroy left over elements, this calls their destructor
-                std::destroy_n(m_data, m_sz);
+            if constexpr (REALLOCATABLE) {
+                // realloc can often grow the block in place, otherwise it copies the bytes for us
+                if (new_capacity != 0) {
+                    void* replacement = std::realloc(m_data, new_capacity * sizeof(T));
 
-                // Delete old memory
-                delete[] m_data;
+                    if (replacement == nullptr) {
+                        // m_data is still valid in this case
+                        throw std::bad_alloc{};
+                    }
 
-                m_data = replacement;
-                m_cap = new_capacity;
+                    // Counted as a free of the old block and a new one, like the path below
+                    if (m_data != nullptr) {
+                        instrumentation::record<vector>(instrumentation::event_kind::deallocate, m_cap * sizeof(T), m_cap, 0);
+                    }
+
+                    instrumentation::record<vector>(instrumentation::event_kind::allocate, new_capacity * sizeof(T), new_capacity, 0);
+
+                    m_data = static_cast<pointer>(replacement);
+                    m_cap = new_capacity;
+                    return;
+                }
+            }
+
+            // Only raw storage, nothing is default-constructed here
+            pointer replacement = allocate(new_capacity);
+
+            // Move over contents of array to replacement
+            try {
+                move_construct(m_data, m_sz, replacement);
+            } catch (...) {
+                deallocate(replacement, new_capacity);
+                throw;
+            }
+
+            // Destroy left over elements, this calls their destructor
+            destroy(m_data, m_sz);
+
+            // Delete old memory
+            deallocate(m_data, m_cap);
+
+            m_data = replacement;
+            m_cap = new_capacity;
+        }
+
+        template <typename Construct>
+        void resize_with(std::size_t new_size, Construct construct) {
+            if (new_size <= m_sz) {
+                destroy(m_data + new_size, m_sz - new_size);
+                m_sz = new_size;
+                return;
+            }
+
+            adjust_cap(new_size - m_sz);
+
+            // Grow one element at a time so m_sz only counts elements that have been constructed
+            while (m_sz < new_size) {
+                construct(m_data + m_sz);
+                ++m_sz;
             }
         }
 
+        // Relocatable elements are shifted with memmove instead of one by one
+        static constexpr bool RELOCATABLE = is_trivially_relocatable_v<T>;
+
+        // With the default allocator relocatable elements live in malloc memory so growth can use realloc.
+        // Over-aligned types can not come from malloc, those take the normal path
+        static constexpr bool REALLOCATABLE = RELOCATABLE and std::is_same_v<Allocator, std::allocator<T>>
+                                              and alignof(T) <= alignof(std::max_align_t);
+
+        // new_capacity * sizeof(T) has to fit in a std::size_t, otherwise malloc/realloc would get a wrapped,
+        // far too small size (realloc(p, 0) even frees p)
+        void check_capacity(std::size_t new_capacity) const {
+            if (new_capacity > max_size()) {
+                // The number of bytes would overflow
+                throw "vector_error: capacity exceeds max_size()\n";
+            }
+        }
+
+        // Raw storage helpers, unlike new T[] these do not construct (or destroy) any elements
+        pointer allocate(std::size_t capacity) {
+            check_capacity(capacity);
+
+            pointer data;
+
+            if constexpr (REALLOCATABLE) {
+                data = static_cast<pointer>(std::malloc(capacity * sizeof(T)));
+
+                if (data == nullptr and capacity != 0) {
+                    throw std::bad_alloc{};
+                }
+            } else {
+                data = allocator_traits::allocate(m_allocator, capacity);
+            }
+
+            if (data != nullptr) {
+                instrumentation::record<vector>(instrumentation::event_kind::allocate, capacity * sizeof(T), capacity, 0);
+            }
+
+            return data;
+        }
+
+        void deallocate(pointer data, std::size_t capacity) noexcept {
+            if (data != nullptr) {
+                instrumentation::record<vector>(instrumentation::event_kind::deallocate, capacity * sizeof(T), capacity, 0);
+            }
+
+            if constexpr (REALLOCATABLE) {
+                std::free(data);
+            } else if (data != nullptr) {
+                allocator_traits::deallocate(m_allocator, data, capacity);
+            }
+        }
+
+        // Elements are constructed and destroyed through the allocator, so e.g. a std::pmr allocator
+        // can pass itself on to elements that use one as well
+        template <typename... Args>
+        void construct(pointer slot, Args&&... args) {
+            allocator_traits::construct(m_allocator, slot, std::forward<Args>(args)...);
+        }
+
+        void destroy(pointer first, std::size_t count) noexcept {
+            for (std::size_t i = 0; i < count; i++) {
+                allocator_traits::destroy(m_allocator, first + i);
+            }
+        }
+
+        // Moves count elements from source to destination by their bytes, the ranges may overlap.
+        // Afterwards the source slots are raw memory, their destructors must not run
+        static void relocate(const_pointer source, std::size_t count, pointer destination) noexcept {
+            if (count == 0) {
+                return;
+            }
+
+            std::memmove(static_cast<void*>(destination), static_cast<const void*>(source), count * sizeof(T));
+        }
+
+        // Copies count elements into raw memory at destination.
+        // If a copy throws the copies made so far are destroyed again
+        void copy_construct(const_pointer source, std::size_t count, pointer destination) {
+            instrumentation::record<vector>(instrumentation::event_kind::copy, count * sizeof(T), 0, count);
+
+            if constexpr (std::is_trivially_copyable_v<T>) {
+                if (count != 0) {
+                    std::memcpy(static_cast<void*>(destination), static_cast<const void*>(source), count * sizeof(T));
+                }
+            } else {
+                std::size_t constructed = 0;
+
+                try {
+                    for (; constructed < count; constructed++) {
+                        construct(destination + constructed, source[constructed]);
+                    }
+                } catch (...) {
+                    destroy(destination, constructed);
+                    throw;
+                }
+            }
+        }
+
+        // Same as copy_construct, but moves the elements
+        void move_construct(pointer source, std::size_t count, pointer destination) {
+            std::size_t constructed = 0;
+
+            try {
+                for (; constructed < count; constructed++) {
+                    construct(destination + constructed, std::move(source[constructed]));
+                }
+            } catch (...) {
+                destroy(destination, constructed);
+                throw;
+            }
+        }
+
+        // Raw room for a single element that is built before it is relocated into the buffer
+        struct staging_slot {
+            alignas(T) std::byte bytes[sizeof(T)];
+
+            pointer get() noexcept {
+                return reinterpret_cast<pointer>(bytes);
+            }
+        };
+
+        [[no_unique_address]] Allocator m_allocator;
         pointer m_data;
         std::size_t m_cap;
         std::size_t m_sz;
     };
 
+    namespace pmr {
+        // A vector that gets its memory from a std::pmr::memory_resource, e.g. a std::pmr::monotonic_buffer_resource
+        template <typename T, typename GrowthPolicy = growth::doubling>
+        using vector = mc::vector<T, GrowthPolicy, std::pmr::polymorphic_allocator<T>>;
+    }
+
     // Out stream operator for vector
-    template <typename T>
-    std::ostream& operator<<(std::ostream& stream, vector<T>& other) {
+    template <typename T, typename GrowthPolicy, typename Allocator>
+    std::ostream& operator<<(std::ostream& stream, const vector<T, GrowthPolicy, Allocator>& other) {
 
         stream << "mc::vector{";
 
@@ -287,18 +822,18 @@ namespace mc {
 
     // The inequality operator is automatically generated by the compiler if operator== is defined. (Since C++20)
     // See https://en.cppreference.com/w/cpp/language/operators
-    template <typename T>
-    bool operator==(const vector<T>& a, const vector<T>& b) {
+    template <typename T, typename GrowthPolicy, typename Allocator>
+    bool operator==(const vector<T, GrowthPolicy, Allocator>& a, const vector<T, GrowthPolicy, Allocator>& b) {
         // Find the lowest index to avoid out of bounds
         if (a.size() != b.size()) {
             return false;
         }
 
-        for (std::size_t i = 0; i < a.size(); i++) {
-            // We know that other.size() and m_sz are the same because of the above check
-            if (a[i] != b[i])
-                // Return false if element[i] for both is not identical
-                return false;
+        // We know that both sizes are the same because of the above check.
+        // For arithmetic types this compares a whole register of elements at a time
+        if (not simd::equal(a.raw(), b.raw(), a.size())) {
+            // Return false if element[i] for both is not identical
+            return false;
         }
 
         // Return if the capacity is the same for both
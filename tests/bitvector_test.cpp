@@ -0,0 +1,106 @@
+//
+// Created by Camiel Verdult on 17/10/2026.
+//
+
+#include <gtest/gtest.h>
+#include <random>
+#include <sstream>
+#include <vector>
+#include "bitvector.h"
+
+TEST(bitvector, bits) {
+    mc::bitvector bits{true, false, true};
+    ASSERT_EQ(bits.size(), 3);
+    ASSERT_TRUE(bits[0]);
+    ASSERT_FALSE(bits[1]);
+
+    // The proxy writes through and can be assigned from another bit
+    bits[1] = true;
+    bits[0] = bits[2] = false;
+    ASSERT_FALSE(bits[0]);
+    ASSERT_TRUE(bits[1]);
+    bits[1].flip();
+    ASSERT_FALSE(bits.at(1));
+    ASSERT_ANY_THROW(bits.at(3));
+
+    for (int i = 0; i < 200; i++) {
+        bits.push_back(i % 3 == 0);
+    }
+
+    ASSERT_EQ(bits.size(), 203);
+    ASSERT_EQ(bits.words().size(), 4) << "bitvector does not pack 64 bits per word!";
+    ASSERT_EQ(bits.count(), 67);
+
+    bits.pop_back();
+    bits.pop_back();
+    ASSERT_EQ(bits.size(), 201);
+    ASSERT_EQ(bits.count(), 66); // 198 was set
+
+    bits.resize(1000, true);
+    ASSERT_EQ(bits.count(), 66 + 799) << "bitvector resize did not set the new bits!";
+    bits.resize(10);
+    ASSERT_EQ(bits.size(), 10);
+
+    std::stringstream stream;
+    stream << mc::bitvector{true, false, true, true};
+    ASSERT_EQ(stream.str(), "mc::bitvector{1011}");
+}
+
+TEST(bitvector, find) {
+    mc::bitvector bits(1000);
+    ASSERT_EQ(bits.find_first(), mc::bitvector::npos);
+    ASSERT_TRUE(bits.none());
+
+    std::vector<std::size_t> set{3, 64, 65, 500, 999};
+    for (std::size_t index : set) {
+        bits[index] = true;
+    }
+
+    std::vector<std::size_t> found;
+    for (std::size_t i = bits.find_first(); i != mc::bitvector::npos; i = bits.find_next(i)) {
+        found.push_back(i);
+    }
+
+    ASSERT_EQ(found, set) << "bitvector find_first/find_next missed a bit!";
+}
+
+TEST(bitvector, bulk) {
+    // Odd sizes leave a partly used last word, and enough words for the SIMD loops
+    constexpr std::size_t SIZE = 64 * 37 + 13;
+
+    std::mt19937_64 mtw;
+    mtw.seed((int)time(nullptr));
+
+    mc::bitvector a(SIZE), b(SIZE);
+    std::vector<bool> ca(SIZE), cb(SIZE);
+
+    for (std::size_t i = 0; i < SIZE; i++) {
+        ca[i] = a[i] = mtw() % 2;
+        cb[i] = b[i] = mtw() % 3 == 0;
+    }
+
+    mc::bitvector both = a & b;
+    mc::bitvector either = a | b;
+    mc::bitvector one = a ^ b;
+    mc::bitvector not_a = ~a;
+
+    std::size_t expected_count = 0;
+    for (std::size_t i = 0; i < SIZE; i++) {
+        ASSERT_EQ(both[i], ca[i] and cb[i]);
+        ASSERT_EQ(either[i], ca[i] or cb[i]);
+        ASSERT_EQ(one[i], ca[i] != cb[i]);
+        ASSERT_EQ(not_a[i], not ca[i]);
+        expected_count += ca[i];
+    }
+
+    ASSERT_EQ(a.count(), expected_count);
+    ASSERT_EQ(not_a.count(), SIZE - expected_count) << "bitvector flip set bits past the end!";
+    ASSERT_EQ(~not_a, a);
+    ASSERT_FALSE(a == not_a);
+
+    mc::bitvector all(SIZE, true);
+    ASSERT_TRUE(all.all());
+    ASSERT_EQ(all.count(), SIZE);
+
+    ASSERT_ANY_THROW(a &= mc::bitvector(SIZE + 1)) << "bitvector combined bitvectors of different sizes!";
+}
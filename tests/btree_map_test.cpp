@@ -0,0 +1,180 @@
+//
+// Created by Camiel Verdult on 17/10/2026.
+//
+
+#include <gtest/gtest.h>
+#include <map>
+#include <random>
+#include <string>
+#include "btree_map.h"
+
+TEST(btree_map, ordered) {
+    mc::btree_map<int, std::string> tree{{3, "three"}, {1, "one"}, {2, "two"}};
+
+    ASSERT_EQ(tree.size(), 3);
+    ASSERT_EQ(tree.find(2)->second, "two");
+    ASSERT_FALSE(tree.contains(4));
+
+    int expected = 1;
+    for (const auto& entry : tree) {
+        ASSERT_EQ(entry.first, expected++) << "btree_map does not iterate in key order!";
+    }
+
+    ASSERT_FALSE(tree.insert_or_assign(2, "TWO").second) << "an existing key was inserted twice!";
+    ASSERT_EQ(tree.find(2)->second, "TWO");
+    ASSERT_FALSE(tree.try_emplace(2, "ignored").second);
+    ASSERT_EQ(tree.find(2)->second, "TWO") << "try_emplace() overwrote an existing value!";
+}
+
+TEST(btree_map, random) {
+    mc::btree_map<uint64_t, uint64_t> tree;
+    std::map<uint64_t, uint64_t> compare_map;
+
+    std::mt19937 mtw;
+    mtw.seed((int)time(nullptr));
+
+    // Enough keys for several levels, with erases to make nodes borrow and merge
+    for (std::size_t i = 0; i < 100000; i++) {
+        uint64_t key = mtw() % 20000;
+
+        if (mtw() % 3 == 0) {
+            ASSERT_EQ(tree.erase_key(key), compare_map.erase(key)) << "erase_key() removed the wrong amount!";
+        } else {
+            tree.insert_or_assign(key, i);
+            compare_map.insert_or_assign(key, i);
+        }
+    }
+
+    ASSERT_EQ(tree.size(), compare_map.size()) << "btree_map has a different size than std::map!";
+    ASSERT_GT(tree.height(), 2);
+
+    auto expected = compare_map.begin();
+    for (const auto& entry : tree) {
+        ASSERT_EQ(entry.first, expected->first) << "btree_map iterates in a different order than std::map!";
+        ASSERT_EQ(entry.second, expected->second);
+        expected++;
+    }
+
+    ASSERT_EQ(expected, compare_map.end());
+
+    // Erase everything, the tree has to shrink back level by level
+    for (auto& entry : compare_map) {
+        ASSERT_EQ(tree.erase_key(entry.first), 1);
+    }
+
+    ASSERT_TRUE(tree.empty());
+    ASSERT_EQ(tree.begin(), tree.end());
+}
+
+TEST(btree_map, bounds) {
+    mc::btree_map<int, int> tree;
+
+    for (int i = 0; i < 1000; i += 10) {
+        tree.insert_or_assign(i, i);
+    }
+
+    ASSERT_EQ(tree.lower_bound(50)->first, 50);
+    ASSERT_EQ(tree.upper_bound(50)->first, 60);
+    ASSERT_EQ(tree.lower_bound(51)->first, 60);
+    ASSERT_EQ(tree.lower_bound(-5)->first, 0);
+    ASSERT_EQ(tree.lower_bound(991), tree.end());
+    ASSERT_EQ(tree.upper_bound(990), tree.end());
+
+    // A range query: every key in [200, 300)
+    int count = 0;
+    for (auto it = tree.lower_bound(200); it != tree.lower_bound(300); ++it) {
+        count++;
+    }
+
+    ASSERT_EQ(count, 10);
+}
+
+TEST(btree_map, bulk_load) {
+    mc::vector<mc::pair<int, int>> sorted;
+
+    for (int i = 0; i < 50000; i++) {
+        sorted.push_back({i * 2, i});
+    }
+
+    mc::btree_map<int, int> tree;
+    tree.bulk_load(std::move(sorted));
+
+    ASSERT_EQ(tree.size(), 50000);
+    ASSERT_EQ(tree.find(1234)->second, 617);
+    ASSERT_FALSE(tree.contains(1235));
+
+    // Inserting after a bulk load has to keep working
+    for (int i = 0; i < 50000; i++) {
+        tree.try_emplace(i * 2 + 1, -i);
+    }
+
+    int expected = 0;
+    for (const auto& entry : tree) {
+        ASSERT_EQ(entry.first, expected++) << "bulk loaded tree is not in order!";
+    }
+
+    mc::vector<mc::pair<int, int>> unsorted{{2, 0}, {1, 0}};
+    ASSERT_THROW(tree.bulk_load(std::move(unsorted)), const char*);
+    ASSERT_EQ(tree.size(), 100000) << "a failed bulk_load changed the tree!";
+}
+
+TEST(btree_map, copy_and_move) {
+    mc::btree_map<std::string, int> tree;
+
+    for (int i = 0; i < 1000; i++) {
+        tree.insert_or_assign(std::to_string(i), i);
+    }
+
+    mc::btree_map<std::string, int> copy{tree};
+    tree.erase_key("500");
+
+    ASSERT_EQ(copy.size(), 1000);
+    ASSERT_EQ(copy.find("500")->second, 500) << "the copy shares nodes with the original!";
+
+    mc::btree_map<std::string, int> moved{std::move(copy)};
+    ASSERT_EQ(moved.size(), 1000);
+    ASSERT_TRUE(copy.empty()) << "move constructor did not leave the tree empty!";
+
+    copy = moved;
+    ASSERT_EQ(copy.find("999")->second, 999) << "copy assignment does not work!";
+}
+
+struct fragile_move {
+    static inline int moves_left = 1000000;
+
+    int value = 0;
+
+    fragile_move() = default;
+    fragile_move(int value) : value{value} {}
+    fragile_move(const fragile_move&) = default;
+    fragile_move(fragile_move&&) = default;
+    fragile_move& operator=(const fragile_move&) = default;
+
+    fragile_move& operator=(fragile_move&& other) {
+        if (moves_left-- == 0) {
+            throw "fragile_move: move failed\n";
+        }
+
+        value = other.value;
+        return *this;
+    }
+};
+
+TEST(btree_map, bulk_load_throws) {
+    mc::btree_map<int, fragile_move> tree;
+    tree.insert_or_assign(1, 10);
+    tree.insert_or_assign(2, 20);
+
+    mc::vector<mc::pair<int, fragile_move>> sorted;
+    for (int i = 0; i < 5000; i++) {
+        sorted.push_back({i, i});
+    }
+
+    // Fails after a good part of the leaves is built, those must be freed and the old tree kept
+    fragile_move::moves_left = 3000;
+    ASSERT_THROW(tree.bulk_load(std::move(sorted)), const char*);
+    fragile_move::moves_left = 1000000;
+
+    ASSERT_EQ(tree.size(), 2) << "a failed bulk_load changed the tree!";
+    ASSERT_EQ(tree.find(2)->second.value, 20);
+}
@@ -0,0 +1,117 @@
+//
+// Created by Camiel Verdult on 17/10/2026.
+//
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "concurrent_map.h"
+
+TEST(concurrent_map, single_thread) {
+    mc::concurrent_map<int, int> map{5};
+    ASSERT_EQ(map.shard_count(), 8) << "concurrent_map did not round the shard count up to a power of two!";
+
+    ASSERT_TRUE(map.insert_or_assign(1, 10));
+    ASSERT_FALSE(map.insert_or_assign(1, 11));
+    ASSERT_FALSE(map.try_emplace(1, 12));
+    ASSERT_EQ(map.find(1), 11);
+    ASSERT_EQ(map.find(2), std::nullopt);
+
+    ASSERT_TRUE(map.update(1, [](int& value) { value *= 2; }));
+    ASSERT_FALSE(map.update(2, [](int& value) { value *= 2; }));
+    ASSERT_EQ(map.find(1), 22);
+
+    ASSERT_EQ(map.erase(1), 1);
+    ASSERT_EQ(map.erase(1), 0);
+    ASSERT_FALSE(map.contains(1));
+    ASSERT_EQ(map.size(), 0);
+}
+
+TEST(concurrent_map, threads) {
+    constexpr int THREADS = 8;
+    constexpr int KEYS = 2000;
+
+    mc::concurrent_map<int, int> map;
+    std::atomic<bool> done{false};
+    std::atomic<int> bad_reads{0};
+
+    // Readers run while the writers insert, a value they see must always match its key
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 2; r++) {
+        readers.emplace_back([&] {
+            while (not done) {
+                for (int key = 0; key < THREADS * KEYS; key += 97) {
+                    auto value = map.find(key);
+                    if (value and *value != key * 2) {
+                        bad_reads++;
+                    }
+                }
+            }
+        });
+    }
+
+    std::vector<std::thread> writers;
+    for (int t = 0; t < THREADS; t++) {
+        writers.emplace_back([&map, t] {
+            for (int i = 0; i < KEYS; i++) {
+                int key = t * KEYS + i;
+                map.insert_or_assign(key, key * 2);
+            }
+        });
+    }
+
+    for (auto& writer : writers) {
+        writer.join();
+    }
+
+    done = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    ASSERT_EQ(bad_reads, 0) << "concurrent_map returned a value that was never written!";
+    ASSERT_EQ(map.size(), THREADS * KEYS) << "concurrent_map lost pairs!";
+
+    std::size_t counted = 0;
+    map.for_each_shard([&counted](const mc::map<int, int>& shard) {
+        counted += shard.size();
+    });
+    ASSERT_EQ(counted, THREADS * KEYS);
+}
+
+TEST(concurrent_map, update) {
+    mc::concurrent_map<int, long> map;
+    map.insert_or_assign(0, 0);
+
+    // update is a locked read-modify-write, so no increment may get lost
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; t++) {
+        threads.emplace_back([&map] {
+            for (int i = 0; i < 10000; i++) {
+                map.update(0, [](long& value) { value++; });
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    ASSERT_EQ(map.find(0), 80000) << "concurrent_map update lost increments!";
+}
+
+TEST(concurrent_map, heterogeneous_lookup) {
+    mc::concurrent_map<std::string, int> map;
+    map.insert_or_assign("session-0123456789abcdef", 7);
+
+    // The shard is picked with the same hash, so a view finds the same shard as the string did
+    std::string_view key{"session-0123456789abcdef"};
+
+    ASSERT_EQ(map.find(key), 7) << "concurrent_map lookup with a std::string_view failed!";
+    ASSERT_TRUE(map.contains("session-0123456789abcdef"));
+    ASSERT_EQ(map.erase(key), 1);
+    ASSERT_FALSE(map.contains(key));
+}
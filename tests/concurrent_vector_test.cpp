@@ -0,0 +1,86 @@
+//
+// Created by Camiel Verdult on 17/10/2026.
+//
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include "concurrent_vector.h"
+
+TEST(concurrent_vector, stable_addresses) {
+    mc::concurrent_vector<std::string> vec;
+
+    std::string& first = vec.push_back("first");
+    const std::string* address = &first;
+
+    // Lots of new segments, but nothing moves
+    for (int i = 0; i < 10000; i++) {
+        vec.emplace_back(std::to_string(i));
+    }
+
+    ASSERT_EQ(&vec[0], address) << "concurrent_vector moved an element!";
+    ASSERT_EQ(first, "first");
+    ASSERT_EQ(vec.size(), 10001);
+    ASSERT_EQ(vec.at(10000), "9999");
+    ASSERT_ANY_THROW(vec.at(10001));
+    ASSERT_GE(vec.capacity(), vec.size());
+
+    std::size_t counted = 0;
+    for (auto& entry : vec) {
+        ASSERT_FALSE(entry.empty());
+        counted++;
+    }
+    ASSERT_EQ(counted, 10001);
+}
+
+TEST(concurrent_vector, threads) {
+    constexpr std::size_t THREADS = 8;
+    constexpr std::size_t PER_THREAD = 20000;
+
+    mc::concurrent_vector<std::size_t> vec;
+    std::atomic<bool> done{false};
+    std::atomic<std::size_t> bad_reads{0};
+
+    // Every element that size() covers has to be fully written while the writers are still going
+    std::thread reader([&] {
+        while (not done) {
+            std::size_t size = vec.size();
+
+            for (std::size_t i = size > 100 ? size - 100 : 0; i < size; i++) {
+                if (vec[i] % 7 != 0) {
+                    bad_reads++;
+                }
+            }
+        }
+    });
+
+    std::vector<std::thread> writers;
+    for (std::size_t t = 0; t < THREADS; t++) {
+        writers.emplace_back([&vec, t] {
+            for (std::size_t i = 0; i < PER_THREAD; i++) {
+                vec.push_back((t * PER_THREAD + i) * 7);
+            }
+        });
+    }
+
+    for (auto& writer : writers) {
+        writer.join();
+    }
+
+    done = true;
+    reader.join();
+
+    ASSERT_EQ(bad_reads, 0) << "concurrent_vector exposed an element before it was written!";
+    ASSERT_EQ(vec.size(), THREADS * PER_THREAD);
+
+    // Every value was appended exactly once
+    std::vector<std::size_t> values(vec.begin(), vec.end());
+    std::sort(values.begin(), values.end());
+
+    for (std::size_t i = 0; i < values.size(); i++) {
+        ASSERT_EQ(values[i], i * 7) << "concurrent_vector lost or duplicated an element!";
+    }
+}
@@ -0,0 +1,114 @@
+//
+// Created by Camiel Verdult on 17/10/2026.
+//
+
+#include <gtest/gtest.h>
+#include <map>
+#include <random>
+#include "flat_map.h"
+
+TEST(flat_map, sorted) {
+    mc::flat_map<int, std::string> table{
+            {3, "three"},
+            {1, "one"},
+            {2, "two"}
+    };
+
+    table.insert(0, "zero");
+    table.insert_or_assign(5, "five");
+
+    ASSERT_EQ(table.size(), 5);
+
+    for (std::size_t i = 1; i < table.size(); i++) {
+        ASSERT_LT(table[i - 1].first, table[i].first) << "flat_map is not sorted by key!";
+    }
+
+    ASSERT_FALSE(table.insert(1, "uno").second) << "insert() should not insert an existing key!";
+    ASSERT_EQ(table.find(1)->second, "one") << "insert() changed the value of an existing key!";
+}
+
+TEST(flat_map, bounds) {
+    mc::flat_map<int, int> table{{10, 1}, {20, 2}, {30, 3}};
+
+    ASSERT_EQ(table.lower_bound(20)->first, 20);
+    ASSERT_EQ(table.upper_bound(20)->first, 30);
+    ASSERT_EQ(table.lower_bound(15)->first, 20);
+    ASSERT_EQ(table.upper_bound(30), table.end());
+
+    auto [first, last] = table.equal_range(20);
+    ASSERT_EQ(last - first, 1) << "equal_range of an existing key should hold one pair!";
+
+    auto [missing_first, missing_last] = table.equal_range(25);
+    ASSERT_EQ(missing_first, missing_last) << "equal_range of a missing key should be empty!";
+
+    ASSERT_FALSE(table.contains(25));
+    ASSERT_EQ(table.erase_key(20), 1);
+    ASSERT_FALSE(table.contains(20)) << "erase_key() did not remove the key!";
+}
+
+TEST(flat_map, bulk_insert) {
+    mc::flat_map<uint32_t, uint32_t> table;
+    std::map<uint32_t, uint32_t> compare;
+
+    std::mt19937 mtw;
+    mtw.seed((int)time(nullptr));
+
+    // A couple of batches with duplicate keys inside a batch and between batches
+    for (std::size_t batch = 0; batch < 5; batch++) {
+        std::vector<mc::pair<uint32_t, uint32_t>> pairs;
+
+        for (uint32_t i = 0; i < 1000; i++) {
+            pairs.emplace_back(mtw() % 3000, i);
+            compare.insert({pairs.back().first, pairs.back().second});
+        }
+
+        table.insert(pairs.begin(), pairs.end());
+    }
+
+    ASSERT_EQ(table.size(), compare.size()) << "bulk insert has the wrong amount of pairs!";
+
+    std::size_t i = 0;
+    for (const auto& [key, value] : compare) {
+        ASSERT_EQ(table[i].first, key) << "bulk insert did not sort properly!";
+        ASSERT_EQ(table[i].second, value) << "bulk insert did not keep the first value of a key!";
+        i++;
+    }
+}
+
+struct fragile_copy {
+    static inline int copies_left = 100;
+
+    int value = 0;
+
+    fragile_copy() = default;
+    fragile_copy(int value) : value{value} {}
+    fragile_copy(fragile_copy&&) = default;
+    fragile_copy& operator=(const fragile_copy&) = default;
+    fragile_copy& operator=(fragile_copy&&) = default;
+
+    fragile_copy(const fragile_copy& other) : value{other.value} {
+        if (copies_left-- == 0) {
+            throw "fragile_copy: copy failed\n";
+        }
+    }
+};
+
+TEST(flat_map, bulk_insert_throws) {
+    mc::flat_map<int, fragile_copy> table;
+    table.insert(5, 50);
+    table.insert(1, 10);
+
+    std::vector<mc::pair<int, fragile_copy>> pairs;
+    for (int i = 10; i > 0; i--) {
+        pairs.emplace_back(i, i * 10);
+    }
+
+    // The fourth copy fails, the three pairs before it must not stay behind
+    fragile_copy::copies_left = 3;
+    ASSERT_THROW(table.insert(pairs.begin(), pairs.end()), const char*);
+    fragile_copy::copies_left = 100;
+
+    ASSERT_EQ(table.size(), 2) << "a failed bulk insert left pairs behind!";
+    ASSERT_EQ(table[0].first, 1);
+    ASSERT_EQ(table[1].first, 5);
+}
@@ -0,0 +1,173 @@
+//
+// Created by Camiel Verdult on 17/10/2026.
+//
+
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <string>
+#include "btree_map.h"
+#include "concurrent_vector.h"
+#include "map.h"
+#include "mmap_vector.h"
+#include "small_vector.h"
+#include "vector.h"
+
+static_assert(mc::instrumentation::ENABLED, "this test has to be built with MC_INSTRUMENTATION=1");
+
+namespace {
+    std::size_t reallocations_seen = 0;
+
+    void count_reallocations(const mc::instrumentation::event& event) {
+        if (event.kind == mc::instrumentation::event_kind::reallocate) {
+            reallocations_seen++;
+        }
+    }
+}
+
+TEST(instrumentation, counters) {
+    using vector_type = mc::vector<std::string>;
+    mc::instrumentation::reset();
+
+    {
+        vector_type vec(4);
+
+        // 4 -> 8 -> 16 with doubling, 10 strings end up in a capacity of 16
+        for (int i = 0; i < 10; i++) {
+            vec.push_back(std::to_string(i));
+        }
+
+        vector_type copy{vec};
+    }
+
+    auto& totals = mc::instrumentation::counters_of<vector_type>();
+    ASSERT_EQ(totals.allocations, 4) << "the first buffer, two growths and the copy";
+    ASSERT_EQ(totals.deallocations, 4);
+    ASSERT_EQ(totals.bytes_allocated, totals.bytes_deallocated);
+    ASSERT_EQ(totals.reallocations, 2);
+    ASSERT_EQ(totals.elements_moved, 4 + 8);
+    ASSERT_EQ(totals.elements_copied, 10);
+    ASSERT_EQ(totals.peak_capacity, 16);
+    ASSERT_EQ(totals.slack_bytes, 2 * 6 * sizeof(std::string)) << "both vectors were freed with 6 unused slots";
+
+    // The registry knows the type by its readable name
+    bool found = false;
+    for (const auto& report : mc::instrumentation::reports()) {
+        if (report.container.find("mc::vector<std::__cxx11::basic_string") != std::string::npos or
+            report.container.find("mc::vector<std::basic_string") != std::string::npos) {
+            found = report.reallocations == 2;
+        }
+    }
+    ASSERT_TRUE(found) << "the registry does not list mc::vector<std::string>!";
+}
+
+TEST(instrumentation, realloc_path_and_hook) {
+    mc::instrumentation::reset();
+    mc::instrumentation::hook_type previous = mc::instrumentation::set_hook(&count_reallocations);
+
+    {
+        // Trivially relocatable pairs grow with realloc, that path has to be counted the same way
+        mc::map<int, int> map;
+        for (int i = 0; i < 100; i++) {
+            map.push_back(i, i);
+        }
+    }
+
+    mc::instrumentation::set_hook(previous);
+
+    auto& totals = mc::instrumentation::counters_of<mc::map<int, int>::vector_template>();
+    ASSERT_EQ(totals.reallocations, 3) << "20 -> 40 -> 80 -> 160";
+    ASSERT_EQ(totals.bytes_allocated, totals.bytes_deallocated) << "realloc growth is not balanced!";
+    ASSERT_GE(reallocations_seen, 3) << "the hook was not called!";
+}
+
+TEST(instrumentation, copy_paths) {
+    using vector_type = mc::vector<std::string>;
+    mc::instrumentation::reset();
+
+    {
+        vector_type vec;
+        std::string value{"copied"};
+
+        vec.push_back(value);
+        vec.push_back(std::string{"moved"});
+        vec.insert(0, value);
+        vec.emplace_back(value);
+        vec.emplace_back(3, 'x');
+
+        // Two new elements, both copies of value
+        vec.resize(7, value);
+    }
+
+    ASSERT_EQ(mc::instrumentation::counters_of<vector_type>().elements_copied, 5) << "a copying path was not counted!";
+}
+
+TEST(instrumentation, other_containers) {
+    mc::instrumentation::reset();
+
+    {
+        // Only the heap buffer counts, the first 2 elements are inline
+        mc::small_vector<int, 2> small;
+        for (int i = 0; i < 10; i++) {
+            small.push_back(int{i});
+        }
+
+        int value = 10;
+        small.push_back(value);
+    }
+
+    auto& small = mc::instrumentation::counters_of<mc::small_vector<int, 2>>();
+    ASSERT_GE(small.reallocations, 2);
+    ASSERT_EQ(small.allocations, small.reallocations);
+    ASSERT_EQ(small.allocations, small.deallocations);
+    ASSERT_EQ(small.bytes_allocated, small.bytes_deallocated);
+    ASSERT_EQ(small.elements_copied, 1);
+
+    {
+        // 100 elements need the segments of 32, 64 and 128
+        mc::concurrent_vector<int> vec;
+        for (int i = 0; i < 100; i++) {
+            vec.push_back(int{i});
+        }
+    }
+
+    auto& concurrent = mc::instrumentation::counters_of<mc::concurrent_vector<int>>();
+    ASSERT_EQ(concurrent.allocations, 3);
+    ASSERT_EQ(concurrent.deallocations, 3);
+    ASSERT_EQ(concurrent.peak_capacity, 32 + 64 + 128);
+    ASSERT_EQ(concurrent.slack_bytes, (32 + 64 + 128 - 100) * sizeof(int));
+
+    {
+        mc::btree_map<int, int> tree;
+        for (int i = 0; i < 1000; i++) {
+            tree.insert_or_assign(i, i);
+        }
+
+        mc::btree_map<int, int> copy{tree};
+    }
+
+    auto& btree = mc::instrumentation::counters_of<mc::btree_map<int, int>>();
+    ASSERT_GT(btree.allocations, 2) << "the nodes of the btree_map were not counted!";
+    ASSERT_EQ(btree.allocations, btree.deallocations);
+    ASSERT_EQ(btree.bytes_allocated, btree.bytes_deallocated);
+    ASSERT_EQ(btree.elements_copied, 1000);
+
+    std::string path = (std::filesystem::temp_directory_path() / ("mc_instrumentation_" + std::to_string(::getpid()))).string();
+    std::filesystem::remove(path);
+
+    {
+        // 4 -> 8 -> 16
+        mc::mmap_vector<int> vec{path, 4};
+        for (int i = 0; i < 10; i++) {
+            vec.push_back(i);
+        }
+    }
+
+    std::filesystem::remove(path);
+
+    auto& mapped = mc::instrumentation::counters_of<mc::mmap_vector<int>>();
+    ASSERT_EQ(mapped.reallocations, 2);
+    ASSERT_EQ(mapped.allocations, 3);
+    ASSERT_EQ(mapped.deallocations, 3);
+    ASSERT_EQ(mapped.elements_copied, 10) << "push_back of mmap_vector always copies";
+    ASSERT_EQ(mapped.peak_capacity, 16);
+}
@@ -4,7 +4,13 @@
 
 #include <gtest/gtest.h>
 #include "map.h"
+#include <algorithm>
+#include <memory_resource>
 #include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
 
 TEST(map, creation) {
     // Initialise 2 empty vectors and see what size they have
@@ -130,4 +136,239 @@ TEST(map, operator_is) {
     smol = copy;
 
     ASSERT_EQ(smol, copy) << "operator= does not work!";
-}
\ No newline at end of file
+}
+
+TEST(map, find) {
+    mc::map<int, std::string> hash_map{
+            {1, "test1"},
+            {2, "test2"},
+            {3, "test3"}
+    };
+
+    ASSERT_TRUE(hash_map.contains(2)) << "contains() can not find an existing key!";
+    ASSERT_FALSE(hash_map.contains(4)) << "contains() finds a key that is not there!";
+    ASSERT_EQ(hash_map.find(3)->second, "test3") << "find() returns the wrong pair!";
+    ASSERT_EQ(hash_map.find(4), hash_map.end()) << "find() should return end() for a missing key!";
+
+    // Positional functions move pairs around, lookups should still work afterwards
+    hash_map.insert(0, 4, "test4");
+    hash_map.sort();
+    ASSERT_EQ(hash_map.find(4)->second, "test4") << "find() does not work after insert(i) and sort()!";
+
+    auto [existing, inserted] = hash_map.try_emplace(1, "other");
+    ASSERT_FALSE(inserted) << "try_emplace() inserted a key that already exists!";
+    ASSERT_EQ(existing->second, "test1") << "try_emplace() changed the value of an existing key!";
+
+    auto [assigned, added] = hash_map.insert_or_assign(1, "other");
+    ASSERT_FALSE(added) << "insert_or_assign() inserted a key that already exists!";
+    ASSERT_EQ(assigned->second, "other") << "insert_or_assign() did not assign the new value!";
+    ASSERT_EQ(hash_map.size(), 4);
+}
+
+TEST(map, reindex) {
+    mc::map<int, std::string> hash_map{
+            {1, "test1"},
+            {2, "test2"},
+            {3, "test3"}
+    };
+
+    // Only reading through the non-const accessors, the index stays valid
+    std::size_t length = 0;
+    for (auto& entry : hash_map) {
+        length += entry.second.size();
+    }
+
+    std::stringstream printed;
+    printed << hash_map;
+
+    ASSERT_EQ(length, 15);
+    ASSERT_EQ(hash_map.find(2)->second, "test2");
+
+    // Changing keys and the order through them needs a reindex()
+    hash_map[0].first = 7;
+    std::reverse(hash_map.begin(), hash_map.end());
+    hash_map.reindex();
+
+    ASSERT_FALSE(hash_map.contains(1)) << "reindex() kept a key that was changed!";
+    ASSERT_EQ(hash_map.find(7)->second, "test1") << "reindex() did not pick up a changed key!";
+    ASSERT_EQ(hash_map.find(3), hash_map.begin()) << "reindex() did not pick up the new order!";
+}
+
+TEST(map, erase_key) {
+    mc::map<uint64_t, uint64_t> hash_map;
+    std::unordered_map<uint64_t, uint64_t> compare_map;
+
+    std::mt19937 mtw;
+    mtw.seed((int)time(nullptr));
+
+    // Mix inserts and erases so the index has to grow and shift entries back
+    for (std::size_t i = 0; i < 10000; i++) {
+        uint64_t key = mtw() % 2000;
+
+        if (mtw() % 3 == 0) {
+            ASSERT_EQ(hash_map.erase_key(key), compare_map.erase(key)) << "erase_key() removed the wrong amount!";
+        } else {
+            hash_map.insert_or_assign(key, i);
+            compare_map.insert_or_assign(key, i);
+        }
+    }
+
+    ASSERT_EQ(hash_map.size(), compare_map.size()) << "mc::map has a different size than std::unordered_map!";
+
+    for (uint64_t key = 0; key < 2000; key++) {
+        auto found = compare_map.find(key);
+
+        if (found == compare_map.end()) {
+            ASSERT_FALSE(hash_map.contains(key)) << "mc::map contains an erased key!";
+        } else {
+            ASSERT_EQ(hash_map.find(key)->second, found->second) << "mc::map has the wrong value for a key!";
+        }
+    }
+}
+
+// Every key hashes to one of 4 values, so probe runs cross many groups of control bytes and wrap around the end
+struct colliding_key {
+    int value;
+
+    bool operator==(const colliding_key& other) const = default;
+};
+
+template<>
+struct std::hash<colliding_key> {
+    std::size_t operator()(const colliding_key& key) const noexcept {
+        return static_cast<std::size_t>(key.value % 4);
+    }
+};
+
+TEST(map, collisions) {
+    mc::map<colliding_key, int> hash_map;
+
+    for (int i = 0; i < 300; i++) {
+        hash_map.insert_or_assign({i}, i);
+    }
+
+    // Erase every third key, the entries behind them have to be shifted back
+    for (int i = 0; i < 300; i += 3) {
+        ASSERT_EQ(hash_map.erase_key({i}), 1) << "erase_key() did not find a colliding key!";
+    }
+
+    for (int i = 0; i < 300; i++) {
+        if (i % 3 == 0) {
+            ASSERT_FALSE(hash_map.contains({i})) << "mc::map contains an erased colliding key!";
+        } else {
+            ASSERT_EQ(hash_map.find({i})->second, i) << "mc::map lost a colliding key!";
+        }
+    }
+
+    ASSERT_EQ(hash_map.size(), 200);
+    ASSERT_EQ(hash_map.raw().size(), 200) << "the pairs are not contiguous anymore!";
+}
+
+TEST(map, incremental_rehash) {
+    mc::map<uint64_t, uint64_t> hash_map;
+    std::unordered_map<uint64_t, uint64_t> compare_map;
+
+    hash_map.incremental_rehash(true);
+
+    std::mt19937 mtw;
+    mtw.seed((int)time(nullptr));
+
+    // Lookups and erases also have to work while the index is halfway moving to a bigger table
+    for (std::size_t i = 0; i < 50000; i++) {
+        uint64_t key = mtw() % 20000;
+
+        switch (mtw() % 5) {
+            case 0:
+                ASSERT_EQ(hash_map.erase_key(key), compare_map.erase(key)) << "erase_key() removed the wrong amount!";
+                break;
+            case 1:
+                if (hash_map.size() > 0) {
+                    compare_map.erase(hash_map[hash_map.size() - 1].first);
+                    hash_map.pop_back();
+                }
+                break;
+            default:
+                hash_map.insert_or_assign(key, i);
+                compare_map.insert_or_assign(key, i);
+        }
+
+        uint64_t probe = mtw() % 20000;
+        auto found = compare_map.find(probe);
+
+        if (found == compare_map.end()) {
+            ASSERT_FALSE(hash_map.contains(probe)) << "mc::map contains an erased key while rehashing!";
+        } else {
+            ASSERT_EQ(hash_map.find(probe)->second, found->second) << "mc::map lost a key while rehashing!";
+        }
+    }
+
+    ASSERT_EQ(hash_map.size(), compare_map.size()) << "mc::map has a different size than std::unordered_map!";
+}
+
+TEST(map, reserve) {
+    mc::map<int, int> hash_map;
+    hash_map.reserve(1000);
+
+    const auto* data = std::as_const(hash_map).raw().raw();
+
+    for (int i = 0; i < 1000; i++) {
+        hash_map.try_emplace(i, i);
+    }
+
+    ASSERT_EQ(std::as_const(hash_map).raw().raw(), data) << "reserve() did not make room for all pairs!";
+    ASSERT_EQ(hash_map.find(999)->second, 999);
+}
+
+TEST(map, heterogeneous_lookup) {
+    mc::map<std::string, int> hash_map;
+
+    // Longer than the small string buffer, so a temporary std::string would have to allocate
+    hash_map.insert_or_assign("/api/v1/users/profile/settings", 1);
+    hash_map.insert_or_assign("/api/v1/orders/history/latest", 2);
+
+    std::string_view request{"GET /api/v1/orders/history/latest HTTP/1.1"};
+    std::string_view path = request.substr(4, 29);
+
+    ASSERT_EQ(hash_map.find(path)->second, 2) << "lookup with a std::string_view failed!";
+    ASSERT_TRUE(hash_map.contains("/api/v1/users/profile/settings")) << "lookup with a const char* failed!";
+    ASSERT_FALSE(hash_map.contains(std::string_view{"/api/v1"})) << "a prefix of a key was found!";
+
+    ASSERT_EQ(hash_map.erase_key(path), 1) << "erase_key() with a std::string_view failed!";
+    ASSERT_FALSE(hash_map.contains(path));
+
+    static_assert(mc::lookup_key<std::string_view, std::string>);
+    static_assert(mc::lookup_key<const char*, std::string>);
+    static_assert(not mc::lookup_key<long, int>, "only transparent hashes accept other key types");
+}
+
+TEST(map, pmr) {
+    // Everything of a request lives in one buffer and is released at once
+    std::pmr::monotonic_buffer_resource arena;
+
+    mc::pmr::map<int, int> hash_map{&arena};
+
+    for (int i = 0; i < 1000; i++) {
+        hash_map.insert_or_assign(i, i * 2);
+    }
+
+    ASSERT_EQ(hash_map.get_allocator().resource(), &arena) << "pmr map does not use its memory resource!";
+    ASSERT_EQ(hash_map.find(500)->second, 1000) << "pmr map lookup failed!";
+}
+
+TEST(map, move) {
+    mc::map<int, std::string> hash_map{{1, "test1"}, {2, "test2"}};
+    const auto* data = hash_map.raw().raw();
+
+    mc::map<int, std::string> moved{std::move(hash_map)};
+    ASSERT_EQ(moved.raw().raw(), data) << "move constructor copied the pairs instead of taking them over!";
+    ASSERT_EQ(moved.find(2)->second, "test2") << "lookup does not work after a move!";
+    ASSERT_EQ(hash_map.size(), 0) << "move constructor did not leave the map empty!";
+
+    hash_map.insert_or_assign(3, "test3");
+    ASSERT_TRUE(hash_map.contains(3)) << "a moved-from map can not be used again!";
+
+    hash_map = std::move(moved);
+    ASSERT_EQ(hash_map.find(1)->second, "test1") << "move assignment does not work!";
+
+    static_assert(std::is_nothrow_move_constructible_v<mc::map<int, std::string>>);
+}
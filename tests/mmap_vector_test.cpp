@@ -0,0 +1,124 @@
+//
+// Created by Camiel Verdult on 17/10/2026.
+//
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <filesystem>
+#include <random>
+#include "mmap_vector.h"
+#include "pair.h"
+
+// Gives every test its own file and removes it afterwards
+struct temporary_file {
+    std::string path;
+
+    explicit temporary_file(const std::string& name) :
+        path{(std::filesystem::temp_directory_path() / ("mc_" + name + "_" + std::to_string(::getpid()))).string()} {
+        std::filesystem::remove(path);
+    }
+
+    ~temporary_file() {
+        std::filesystem::remove(path);
+    }
+};
+
+TEST(mmap_vector, persistence) {
+    temporary_file file{"persistence"};
+
+    {
+        mc::mmap_vector<int> vec{file.path, 4};
+
+        // This grows the file a couple of times
+        for (int i = 0; i < 1000; i++) {
+            vec.push_back(i);
+        }
+
+        vec.flush();
+    }
+
+    // Opening the file again gives back the same vector
+    mc::mmap_vector<int> reopened{file.path};
+    ASSERT_EQ(reopened.size(), 1000) << "mmap_vector did not keep its size in the file!";
+
+    for (int i = 0; i < 1000; i++) {
+        ASSERT_EQ(reopened[i], i) << "mmap_vector did not keep its elements in the file!";
+    }
+}
+
+TEST(mmap_vector, sort) {
+    temporary_file file{"sort"};
+    mc::mmap_vector<mc::pair<uint64_t, uint64_t>> vec{file.path};
+    std::vector<mc::pair<uint64_t, uint64_t>> compare;
+
+    std::mt19937_64 mtw;
+    mtw.seed((int)time(nullptr));
+
+    for (std::size_t i = 0; i < 5000; i++) {
+        mc::pair<uint64_t, uint64_t> entry{mtw() % 100, mtw()};
+        vec.push_back(entry);
+        compare.push_back(entry);
+    }
+
+    vec.sort();
+    std::sort(compare.begin(), compare.end());
+
+    ASSERT_TRUE(std::equal(vec.begin(), vec.end(), compare.begin())) << "mmap_vector sort failed!";
+}
+
+TEST(mmap_vector, wrong_type) {
+    temporary_file file{"wrong_type"};
+
+    {
+        mc::mmap_vector<uint64_t> vec{file.path};
+        vec.push_back(1);
+    }
+
+    // A file with 8 byte elements can not be opened as a vector of 4 byte elements
+    ASSERT_ANY_THROW(mc::mmap_vector<uint32_t>{file.path}) << "mmap_vector opened a file of a different type!";
+}
+
+TEST(mmap_vector, damaged_size) {
+    temporary_file file{"damaged_size"};
+
+    {
+        mc::mmap_vector<uint64_t> vec{file.path, 16};
+        vec.push_back(1);
+    }
+
+    // Cut the file so the size in the header claims more elements than the file holds
+    std::filesystem::resize_file(file.path, 64 + 4 * sizeof(uint64_t));
+
+    {
+        std::FILE* stream = std::fopen(file.path.c_str(), "r+b");
+        ASSERT_NE(stream, nullptr);
+
+        uint64_t size = 1000;
+        std::fseek(stream, 16, SEEK_SET);
+        std::fwrite(&size, sizeof(size), 1, stream);
+        std::fclose(stream);
+    }
+
+    ASSERT_THROW(mc::mmap_vector<uint64_t>{file.path}, const char*) << "mmap_vector opened a file with a bad size!";
+}
+
+TEST(mmap_vector, moved_from) {
+    temporary_file file{"moved_from"};
+
+    mc::mmap_vector<int> vec{file.path};
+    vec.push_back(1);
+
+    mc::mmap_vector<int> moved{std::move(vec)};
+
+    // A moved-from vector has no mapping left and has to report itself as empty
+    ASSERT_EQ(vec.size(), 0);
+    ASSERT_EQ(vec.capacity(), 0);
+    ASSERT_EQ(vec.begin(), vec.end());
+    ASSERT_EQ(moved.size(), 1);
+
+    // Nothing to erase, flush or sort, but adding needs a file
+    vec.erase();
+    vec.flush();
+    vec.sort();
+    ASSERT_THROW(vec.push_back(2), const char*);
+}
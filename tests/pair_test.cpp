@@ -23,4 +23,18 @@ TEST(pair, compare) {
     ASSERT_TRUE(int_map < compare_pair) << "Compare <operator of pair is broken!";
     ASSERT_EQ(compare_pair, mc::make_pair(3, 4));
 
-}
\ No newline at end of file
+}
+
+TEST(pair, move) {
+    mc::pair<int, std::string> a{1, "a string that is too long for the small string optimisation"};
+    const char* data = a.second.data();
+
+    mc::pair<int, std::string> b{std::move(a)};
+    ASSERT_EQ(b.second.data(), data) << "move constructor of pair copied the string!";
+
+    a = std::move(b);
+    ASSERT_EQ(a.second.data(), data) << "move assignment of pair copied the string!";
+
+    static_assert(std::is_nothrow_move_constructible_v<mc::pair<int, std::string>>);
+    static_assert(std::is_trivially_copyable_v<mc::pair<int, int>>);
+}
@@ -0,0 +1,77 @@
+//
+// Created by Camiel Verdult on 17/10/2026.
+//
+
+#include <gtest/gtest.h>
+#include <ranges>
+#include <sstream>
+#include <string>
+#include "map.h"
+#include "ranges.h"
+#include "vector.h"
+
+static_assert(std::ranges::contiguous_range<mc::vector<int>>);
+static_assert(std::ranges::contiguous_range<const mc::vector<int>>);
+static_assert(std::ranges::sized_range<mc::vector<int>>);
+static_assert(std::ranges::contiguous_range<mc::map<int, int>>);
+static_assert(std::ranges::contiguous_range<const mc::map<int, int>>);
+
+TEST(ranges, pipeline) {
+    mc::vector<int> vec;
+    for (int i = 0; i < 100; i++) {
+        vec.push_back(i);
+    }
+
+    // Works with the std range algorithms and std::span
+    ASSERT_EQ(std::ranges::count_if(vec, [](int i) { return i % 2 == 0; }), 50);
+    std::span<const int> span{vec};
+    ASSERT_EQ(span.size(), 100);
+
+    auto even_squares = vec
+            | std::views::filter([](int i) { return i % 2 == 0; })
+            | std::views::transform([](int i) { return static_cast<long>(i) * i; })
+            | mc::to<mc::vector>();
+
+    static_assert(std::is_same_v<decltype(even_squares), mc::vector<long>>);
+    ASSERT_EQ(even_squares.size(), 50);
+    ASSERT_EQ(even_squares[49], 98 * 98);
+
+    // The size was counted first, so the vector was allocated once with exactly enough room
+    ASSERT_EQ(even_squares.capacity(), 50) << "mc::to did not reserve exactly once!";
+
+    auto strings = mc::to<mc::vector<std::string>>(vec | std::views::take(3) | std::views::transform([](int i) { return std::to_string(i); }));
+    ASSERT_EQ(strings.size(), 3);
+    ASSERT_EQ(strings[2], "2");
+}
+
+TEST(ranges, single_pass) {
+    // An input range can not be counted up front, the vector grows as usual
+    std::istringstream stream{"1 2 3 4 5"};
+    auto numbers = std::views::istream<int>(stream) | mc::to<mc::vector>();
+
+    ASSERT_EQ(numbers.size(), 5);
+    ASSERT_EQ(numbers[4], 5);
+}
+
+TEST(ranges, map_views) {
+    mc::map<int, std::string> map;
+    for (int i = 0; i < 10; i++) {
+        map.push_back(i, std::to_string(i * 10));
+    }
+
+    auto big_keys = map.keys() | std::views::filter([](int key) { return key >= 5; }) | mc::to<mc::vector>();
+    ASSERT_EQ(big_keys.size(), 5);
+    ASSERT_EQ(big_keys[0], 5);
+
+    // values() can change the values in place, the keys and the index are untouched
+    for (auto& value : map.values()) {
+        value += "!";
+    }
+
+    ASSERT_EQ(map.find(3)->second, "30!");
+    ASSERT_EQ(std::ranges::distance(map.keys()), 10);
+
+    const auto& constant = map;
+    auto values = constant.values();
+    ASSERT_EQ(*values.begin(), "0!");
+}
@@ -0,0 +1,186 @@
+//
+// Created by Camiel Verdult on 17/10/2026.
+//
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include "serialize.h"
+
+TEST(serialize, vector_stream) {
+    mc::vector<uint64_t> vec;
+
+    for (uint64_t i = 0; i < 1000; i++) {
+        vec.push_back(i * i);
+    }
+
+    std::stringstream stream;
+    mc::serialization::serialize(vec, stream);
+
+    // Header plus one block of raw elements
+    ASSERT_EQ(stream.str().size(), sizeof(mc::serialization::header) + 1000 * sizeof(uint64_t));
+
+    auto read = mc::serialization::deserialize<mc::vector<uint64_t>>(stream);
+    ASSERT_EQ(read.size(), vec.size()) << "deserialize lost elements!";
+    ASSERT_TRUE(std::equal(read.begin(), read.end(), vec.begin())) << "deserialize changed the elements!";
+}
+
+TEST(serialize, strings) {
+    mc::vector<std::string> vec{"", "short", std::string(100, 'x')};
+    mc::map<int, std::string> map;
+    map.push_back({1, "one"});
+    map.push_back({2, "two"});
+
+    std::stringstream stream;
+    mc::serialization::serialize(vec, stream);
+    mc::serialization::serialize(map, stream);
+
+    auto read_vec = mc::serialization::deserialize<mc::vector<std::string>>(stream);
+    ASSERT_EQ(read_vec.size(), 3);
+    ASSERT_TRUE(std::equal(read_vec.begin(), read_vec.end(), vec.begin())) << "strings did not survive a round trip!";
+
+    auto read_map = mc::serialization::deserialize<mc::map<int, std::string>>(stream);
+    ASSERT_EQ(read_map.size(), 2);
+    ASSERT_EQ(read_map.find(2)->second, "two") << "deserialized map can not find its keys!";
+}
+
+TEST(serialize, file_descriptor) {
+    std::FILE* file = std::tmpfile();
+    ASSERT_NE(file, nullptr);
+    int fd = ::fileno(file);
+
+    mc::map<uint32_t, double> map;
+    for (uint32_t i = 0; i < 500; i++) {
+        map.push_back({i, i / 2.0});
+    }
+
+    mc::serialization::serialize(map, fd);
+    ::lseek(fd, 0, SEEK_SET);
+
+    auto read = mc::serialization::deserialize<mc::map<uint32_t, double>>(fd);
+    std::fclose(file);
+
+    ASSERT_EQ(read.size(), 500);
+    for (uint32_t i = 0; i < 500; i++) {
+        ASSERT_TRUE(read.contains(i)) << "deserialized map is missing a key!";
+        ASSERT_EQ(read.find(i)->second, i / 2.0);
+    }
+}
+
+TEST(serialize, map_view) {
+    mc::map<uint64_t, uint64_t> map;
+    for (uint64_t i = 0; i < 300; i++) {
+        map.push_back({(i * 7919) % 300, i});
+    }
+
+    // Unsorted, the view falls back to a linear scan
+    std::stringstream unsorted;
+    mc::serialization::serialize(map, unsorted);
+
+    map.sort();
+    std::stringstream sorted;
+    mc::serialization::serialize(map, sorted);
+
+    for (auto* stream : {&unsorted, &sorted}) {
+        std::string bytes = stream->str();
+
+        // Copy into a buffer that is aligned like the pairs
+        mc::vector<uint64_t> buffer(bytes.size() / sizeof(uint64_t));
+        buffer.resize(bytes.size() / sizeof(uint64_t));
+        std::memcpy(buffer.raw(), bytes.data(), bytes.size());
+
+        mc::serialization::map_view<uint64_t, uint64_t> view{std::as_bytes(std::span{buffer.raw(), buffer.size()})};
+        ASSERT_EQ(view.size(), 300);
+
+        for (uint64_t key = 0; key < 300; key++) {
+            auto* found = view.find(key);
+            ASSERT_NE(found, view.end()) << "map_view can not find a key!";
+            ASSERT_EQ((found->second * 7919) % 300, key);
+
+            // The pairs are used in place
+            ASSERT_GE(reinterpret_cast<const std::byte*>(found), reinterpret_cast<const std::byte*>(buffer.raw()));
+        }
+
+        ASSERT_FALSE(view.contains(300));
+    }
+}
+
+TEST(serialize, bad_input) {
+    mc::vector<uint32_t> vec{1, 2, 3};
+    std::stringstream stream;
+    mc::serialization::serialize(vec, stream);
+    std::string bytes = stream.str();
+    auto buffer = std::as_bytes(std::span{bytes.data(), bytes.size()});
+
+    // Wrong element type, not a map, and a truncated buffer
+    ASSERT_ANY_THROW(mc::serialization::deserialize<mc::vector<uint64_t>>(buffer));
+    ASSERT_ANY_THROW((mc::serialization::deserialize<mc::map<uint32_t, uint32_t>>(buffer)));
+    ASSERT_ANY_THROW(mc::serialization::deserialize<mc::vector<uint32_t>>(buffer.first(buffer.size() - 1)));
+
+    auto read = mc::serialization::deserialize<mc::vector<uint32_t>>(buffer);
+    ASSERT_EQ(read.size(), 3);
+    ASSERT_EQ(read[2], 3);
+}
+
+TEST(serialize, damaged_count) {
+    mc::vector<uint64_t> vec{1, 2, 3};
+    std::stringstream stream;
+    mc::serialization::serialize(vec, stream);
+    std::string bytes = stream.str();
+
+    // A count that wraps around when multiplied by the element size, with a payload size that matches the wrap
+    uint64_t count = (uint64_t{1} << 61) + 3;
+    uint64_t payload = count * sizeof(uint64_t);
+    std::memcpy(bytes.data() + 16, &count, sizeof(count));
+    std::memcpy(bytes.data() + 24, &payload, sizeof(payload));
+
+    auto buffer = std::as_bytes(std::span{bytes.data(), bytes.size()});
+    ASSERT_THROW(mc::serialization::deserialize<mc::vector<uint64_t>>(buffer), const char*);
+
+    std::stringstream damaged{bytes};
+    ASSERT_THROW(mc::serialization::deserialize<mc::vector<uint64_t>>(damaged), const char*);
+
+    // A count that does not overflow but is far larger than the blob
+    count = 1'000'000'000;
+    payload = count * sizeof(uint64_t);
+    std::memcpy(bytes.data() + 16, &count, sizeof(count));
+    std::memcpy(bytes.data() + 24, &payload, sizeof(payload));
+
+    buffer = std::as_bytes(std::span{bytes.data(), bytes.size()});
+    ASSERT_THROW(mc::serialization::deserialize<mc::vector<uint64_t>>(buffer), const char*);
+
+    // The same for a map read in place
+    mc::map<uint32_t, uint32_t> map;
+    map.push_back(1, 2);
+
+    std::stringstream map_stream;
+    mc::serialization::serialize(map, map_stream);
+    std::string map_bytes = map_stream.str();
+
+    count = (uint64_t{1} << 61) + 1;
+    payload = count * sizeof(mc::pair<uint32_t, uint32_t>);
+    std::memcpy(map_bytes.data() + 16, &count, sizeof(count));
+    std::memcpy(map_bytes.data() + 24, &payload, sizeof(payload));
+
+    auto map_buffer = std::as_bytes(std::span{map_bytes.data(), map_bytes.size()});
+    ASSERT_THROW((mc::serialization::map_view<uint32_t, uint32_t>{map_buffer}), const char*);
+}
+
+TEST(serialize, damaged_string_length) {
+    mc::vector<std::string> vec{"one", "two"};
+    std::stringstream stream;
+    mc::serialization::serialize(vec, stream);
+    std::string bytes = stream.str();
+
+    // The length of the first string right after the header, far longer than the blob
+    uint64_t length = 1'000'000'000;
+    std::memcpy(bytes.data() + 32, &length, sizeof(length));
+
+    std::stringstream damaged{bytes};
+    ASSERT_THROW(mc::serialization::deserialize<mc::vector<std::string>>(damaged), const char*);
+
+    auto buffer = std::as_bytes(std::span{bytes.data(), bytes.size()});
+    ASSERT_THROW(mc::serialization::deserialize<mc::vector<std::string>>(buffer), const char*);
+}
@@ -0,0 +1,123 @@
+//
+// Created by Camiel Verdult on 17/10/2026.
+//
+
+#include <gtest/gtest.h>
+#include <random>
+#include "small_vector.h"
+
+TEST(small_vector, inline_storage) {
+    mc::small_vector<int, 8> vec{};
+
+    for (int i = 0; i < 8; i++) {
+        vec.push_back(i);
+    }
+
+    ASSERT_FALSE(vec.on_heap()) << "small_vector moved to the heap before it was full!";
+    ASSERT_EQ(vec.capacity(), 8);
+
+    vec.push_back(8);
+    ASSERT_TRUE(vec.on_heap()) << "small_vector did not move to the heap after it was full!";
+
+    for (int i = 0; i < 9; i++) {
+        ASSERT_EQ(vec[i], i) << "small_vector lost elements while moving to the heap!";
+    }
+}
+
+TEST(small_vector, compare_std_vector) {
+    mc::small_vector<std::string, 4> vec{};
+    std::vector<std::string> compare{};
+
+    std::mt19937 mtw;
+    mtw.seed((int)time(nullptr));
+
+    for (std::size_t i = 0; i < 500; i++) {
+        std::string value = "a string that does not fit the small string optimisation " + std::to_string(i);
+        std::size_t index = vec.size() == 0 ? 0 : mtw() % vec.size();
+
+        switch (mtw() % 3) {
+            case 0:
+                vec.push_back(value);
+                compare.push_back(value);
+                break;
+            case 1:
+                vec.insert(index, value);
+                compare.insert(compare.begin() + (std::ptrdiff_t)std::min(index, compare.size()), value);
+                break;
+            default:
+                if (not compare.empty()) {
+                    vec.erase(index);
+                    compare.erase(compare.begin() + (std::ptrdiff_t)index);
+                }
+        }
+    }
+
+    ASSERT_EQ(vec.size(), compare.size()) << "small_vector has the wrong size!";
+    ASSERT_TRUE(std::equal(vec.begin(), vec.end(), compare.begin())) << "small_vector has the wrong content!";
+
+    vec.sort();
+    std::sort(compare.begin(), compare.end());
+    ASSERT_TRUE(std::equal(vec.begin(), vec.end(), compare.begin())) << "small_vector sort failed!";
+}
+
+TEST(small_vector, operator_is) {
+    mc::small_vector<int, 4> small{1, 2};
+    mc::small_vector<int, 4> big{1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+
+    mc::small_vector<int, 4> copy{big};
+    ASSERT_EQ(copy, big) << "copy constructor does not work!";
+
+    // Heap to inline and inline to heap
+    copy = small;
+    ASSERT_EQ(copy, small) << "operator= does not work from inline storage!";
+    ASSERT_FALSE(copy.on_heap());
+
+    small = big;
+    ASSERT_EQ(small, big) << "operator= does not work from heap storage!";
+}
+
+TEST(small_vector, move) {
+    mc::small_vector<std::string, 2> small{"a", "b"};
+    mc::small_vector<std::string, 2> big{"a", "b", "c"};
+    const std::string* data = big.raw();
+
+    mc::small_vector<std::string, 2> moved{std::move(big)};
+    ASSERT_EQ(moved.raw(), data) << "move constructor did not take over the heap buffer!";
+    ASSERT_EQ(big.size(), 0);
+
+    moved = std::move(small);
+    ASSERT_FALSE(moved.on_heap()) << "move assignment from inline storage should stay inline!";
+    ASSERT_EQ(moved[1], "b");
+    ASSERT_EQ(small.size(), 0);
+}
+
+// Throws from its move constructor once moves_left runs out
+struct throwing_move {
+    static inline int moves_left = 0;
+
+    std::string value;
+
+    throwing_move(const char* text) : value{text} {}
+    throwing_move(const throwing_move& other) = default;
+
+    throwing_move(throwing_move&& other) {
+        if (moves_left-- == 0) {
+            throw "throwing_move: out of moves\n";
+        }
+
+        value = std::move(other.value);
+    }
+};
+
+TEST(small_vector, throwing_move) {
+    mc::small_vector<throwing_move, 2> small{"a", "b"};
+
+    // The first move builds the new element, the next one moves "a" to the heap and throws. The heap buffer must not leak
+    throwing_move::moves_left = 1;
+    ASSERT_THROW(small.push_back("c"), const char*);
+
+    throwing_move::moves_left = 100;
+    ASSERT_EQ(small.size(), 2);
+    ASSERT_FALSE(small.on_heap()) << "a failed reallocation moved the elements anyway!";
+    ASSERT_EQ(small[0].value, "a");
+}
@@ -0,0 +1,166 @@
+//
+// Created by Camiel Verdult on 17/10/2026.
+//
+
+#include <gtest/gtest.h>
+#include <iterator>
+#include <numeric>
+#include <random>
+#include <string>
+#include <string_view>
+#include "soa_vector.h"
+#include "soa_map.h"
+
+TEST(soa_vector, columns) {
+    mc::soa_vector<int, double, std::string> soa;
+
+    for (int i = 0; i < 100; i++) {
+        soa.push_back(i, i * 0.5, std::to_string(i));
+    }
+
+    ASSERT_EQ(soa.size(), 100);
+
+    // Each field is one contiguous column
+    std::span<int> ids = soa.column<0>();
+    ASSERT_EQ(ids.size(), 100);
+    ASSERT_EQ(std::accumulate(ids.begin(), ids.end(), 0), 4950);
+    ASSERT_EQ(&soa.column<1>()[1], &soa.column<1>()[0] + 1);
+
+    // Rows are proxies that write through to the columns
+    auto [id, price, name] = soa[10];
+    price = 99.0;
+    ASSERT_EQ(id, 10);
+    ASSERT_EQ(name, "10");
+    ASSERT_EQ(soa.get<1>(10), 99.0) << "soa_vector row proxy did not write through!";
+
+    soa.erase(0);
+    ASSERT_EQ(soa.size(), 99);
+    ASSERT_EQ(soa.get<0>(0), 1);
+    ASSERT_EQ(soa.get<2>(0), "1") << "soa_vector erase left the columns misaligned!";
+
+    soa.erase_unordered(0);
+    ASSERT_EQ(soa.size(), 98);
+    ASSERT_EQ(soa.get<0>(0), 99);
+    ASSERT_EQ(soa.get<2>(0), "99") << "soa_vector erase_unordered left the columns misaligned!";
+
+    ASSERT_ANY_THROW(soa.at(98));
+    ASSERT_ANY_THROW(soa.erase(98));
+
+    std::size_t rows = 0;
+    for (auto [row_id, row_price, row_name] : soa) {
+        ASSERT_EQ(row_name, std::to_string(row_id));
+        rows++;
+    }
+    ASSERT_EQ(rows, 98);
+}
+
+TEST(soa_vector, sort_by) {
+    mc::soa_vector<uint32_t, std::string> soa;
+
+    std::mt19937 mtw;
+    mtw.seed((int)time(nullptr));
+
+    // Enough rows for the radix sort, with duplicate keys to check the sort is stable
+    for (std::size_t i = 0; i < 2000; i++) {
+        soa.push_back(mtw() % 100, std::to_string(i));
+    }
+
+    soa.sort_by<0>();
+
+    for (std::size_t i = 1; i < soa.size(); i++) {
+        ASSERT_LE(soa.get<0>(i - 1), soa.get<0>(i)) << "soa_vector sort_by did not sort!";
+
+        if (soa.get<0>(i - 1) == soa.get<0>(i)) {
+            ASSERT_LT(std::stoul(soa.get<1>(i - 1)), std::stoul(soa.get<1>(i))) << "soa_vector sort_by is not stable!";
+        }
+    }
+
+    // Sorting by a string column takes the comparison path
+    soa.sort_by<1>();
+    ASSERT_TRUE(std::is_sorted(soa.column<1>().begin(), soa.column<1>().end()));
+}
+
+// Throws when it is moved while fail is set, to break a push_back halfway through the columns
+struct fragile_field {
+    static inline bool fail = false;
+
+    fragile_field() = default;
+    fragile_field(const fragile_field&) = default;
+    fragile_field& operator=(const fragile_field&) = default;
+    fragile_field& operator=(fragile_field&&) = default;
+
+    fragile_field(fragile_field&&) {
+        if (fail) {
+            throw "fragile_field: move failed\n";
+        }
+    }
+};
+
+TEST(soa_vector, push_back_rollback) {
+    mc::soa_vector<int, fragile_field> soa;
+    soa.reserve(4);
+    soa.push_back(1, fragile_field{});
+
+    fragile_field::fail = true;
+    ASSERT_THROW(soa.push_back(2, fragile_field{}), const char*);
+    fragile_field::fail = false;
+
+    // The int column got its field before the throw, it has to be taken out again
+    ASSERT_EQ(soa.column<0>().size(), 1) << "soa_vector columns are uneven after a throwing push_back!";
+    ASSERT_EQ(soa.column<1>().size(), 1);
+    ASSERT_EQ(soa.get<0>(0), 1);
+}
+
+TEST(soa_vector, iterator) {
+    using iterator = mc::soa_vector<int, std::string>::iterator;
+
+    // The rows are proxies, not references
+    static_assert(std::is_same_v<std::iterator_traits<iterator>::iterator_category, std::input_iterator_tag>);
+    static_assert(std::forward_iterator<iterator>);
+}
+
+TEST(soa_map, heterogeneous_lookup) {
+    mc::soa_map<std::string, int> map;
+    map.try_emplace("apple", 1);
+    map.try_emplace("banana", 2);
+
+    // No std::string is built for these
+    std::string_view key{"apple"};
+    ASSERT_EQ(*map.find(key), 1);
+    ASSERT_TRUE(map.contains("banana"));
+    ASSERT_FALSE(map.contains(std::string_view{"cherry"}));
+    ASSERT_EQ(map.erase_key(key), 1);
+    ASSERT_FALSE(map.contains("apple"));
+}
+
+TEST(soa_map, find_and_erase) {
+    mc::soa_map<int, std::string> map;
+
+    for (int i = 0; i < 1000; i++) {
+        ASSERT_TRUE(map.try_emplace(i, std::to_string(i)).second);
+    }
+
+    ASSERT_FALSE(map.try_emplace(5, "five").second);
+    ASSERT_FALSE(map.insert_or_assign(5, "five").second);
+    ASSERT_EQ(*map.find(5), "five");
+    ASSERT_EQ(map.find(1000), nullptr);
+
+    // Keys are contiguous and in the same order as the values
+    ASSERT_EQ(map.keys().size(), 1000);
+    ASSERT_EQ(map.keys()[999], 999);
+    ASSERT_EQ(map.values()[999], "999");
+
+    for (int i = 0; i < 1000; i += 2) {
+        ASSERT_EQ(map.erase_key(i), 1);
+    }
+    ASSERT_EQ(map.erase_key(0), 0);
+    ASSERT_EQ(map.size(), 500);
+
+    for (int i = 0; i < 1000; i++) {
+        ASSERT_EQ(map.contains(i), i % 2 == 1) << "soa_map index is out of sync after erase_key!";
+    }
+
+    map.sort();
+    ASSERT_TRUE(std::is_sorted(map.keys().begin(), map.keys().end()));
+    ASSERT_EQ(*map.find(501), "501") << "soa_map index is out of sync after sort!";
+}
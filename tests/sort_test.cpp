@@ -0,0 +1,106 @@
+//
+// Created by Camiel Verdult on 17/10/2026.
+//
+
+#include <gtest/gtest.h>
+#include <random>
+#include "map.h"
+#include "vector.h"
+
+TEST(sort, radix_signed) {
+    // Large enough for the radix sort, and negative numbers have to end up in front
+    mc::vector<int64_t> vec{};
+    std::vector<int64_t> compare{};
+
+    std::mt19937_64 mtw;
+    mtw.seed((int)time(nullptr));
+
+    for (std::size_t i = 0; i < 10000; i++) {
+        auto value = static_cast<int64_t>(mtw());
+        vec.push_back(value);
+        compare.push_back(value);
+    }
+
+    vec.sort();
+    std::sort(compare.begin(), compare.end());
+
+    ASSERT_TRUE(std::equal(vec.begin(), vec.end(), compare.begin())) << "radix sort of signed integers failed!";
+}
+
+TEST(sort, radix_pair) {
+    // Pairs of integers are sorted on second and then on first, which has to match operator<
+    mc::vector<mc::pair<uint16_t, int32_t>> vec{};
+    std::vector<mc::pair<uint16_t, int32_t>> compare{};
+
+    std::mt19937 mtw;
+    mtw.seed((int)time(nullptr));
+
+    for (std::size_t i = 0; i < 10000; i++) {
+        mc::pair<uint16_t, int32_t> value{static_cast<uint16_t>(mtw() % 100), static_cast<int32_t>(mtw())};
+        vec.push_back(value);
+        compare.push_back(value);
+    }
+
+    vec.sort();
+    std::sort(compare.begin(), compare.end());
+
+    ASSERT_TRUE(std::equal(vec.begin(), vec.end(), compare.begin())) << "radix sort of integer pairs failed!";
+}
+
+TEST(sort, parallel) {
+    // Strings can not be radix sorted, this many of them goes through the parallel merge sort
+    std::vector<std::string> compare{};
+
+    std::mt19937 mtw;
+    mtw.seed((int)time(nullptr));
+
+    for (std::size_t i = 0; i < mc::sorting::PARALLEL_THRESHOLD * 4; i++) {
+        compare.push_back(std::to_string(mtw()));
+    }
+
+    std::vector<std::string> parallel{compare};
+
+    mc::sorting::parallel_merge_sort(parallel.data(), parallel.data() + parallel.size(), std::less<>{}, false);
+    std::sort(compare.begin(), compare.end());
+
+    ASSERT_EQ(parallel, compare) << "parallel merge sort failed!";
+}
+
+TEST(sort, parallel_throws) {
+    // An exception from the comparator in one of the worker threads has to reach the caller instead of terminating
+    std::vector<int> values(mc::sorting::PARALLEL_THRESHOLD * 4);
+
+    for (std::size_t i = 0; i < values.size(); i++) {
+        values[i] = static_cast<int>(values.size() - i);
+    }
+
+    auto throwing_less = [](int a, int b) {
+        if (a == 1 or b == 1) {
+            throw "sort_test: comparator failed\n";
+        }
+
+        return a < b;
+    };
+
+    ASSERT_THROW(mc::sorting::parallel_merge_sort(values.data(), values.data() + values.size(), throwing_less, true),
+                 const char*);
+}
+
+TEST(sort, map_by_key) {
+    // Keys are compared only, so pairs with the same key have to keep their insertion order
+    mc::map<int, int> hash_map;
+
+    for (int i = 0; i < 1000; i++) {
+        hash_map.push_back(i % 10, 1000 - i);
+    }
+
+    hash_map.sort();
+
+    for (std::size_t i = 1; i < hash_map.size(); i++) {
+        ASSERT_LE(hash_map[i - 1].first, hash_map[i].first) << "mc::map sort does not sort by key!";
+
+        if (hash_map[i - 1].first == hash_map[i].first) {
+            ASSERT_GT(hash_map[i - 1].second, hash_map[i].second) << "mc::map sort is not stable!";
+        }
+    }
+}
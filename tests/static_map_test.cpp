@@ -0,0 +1,59 @@
+//
+// Created by Camiel Verdult on 17/10/2026.
+//
+
+#include <gtest/gtest.h>
+#include <string_view>
+#include "static_map.h"
+
+enum class opcode { load, store, add, jump };
+
+// Built while compiling, the pairs are given out of order on purpose
+constexpr auto opcode_names = mc::make_static_map<opcode, std::string_view>({
+        {opcode::jump, "jump"},
+        {opcode::load, "load"},
+        {opcode::add, "add"},
+        {opcode::store, "store"}
+});
+
+constexpr auto opcode_values = mc::make_static_map<std::string_view, opcode>({
+        {"store", opcode::store},
+        {"add", opcode::add},
+        {"load", opcode::load},
+        {"jump", opcode::jump}
+});
+
+TEST(static_map, compile_time) {
+    static_assert(opcode_names.size() == 4);
+    static_assert(opcode_names.at(opcode::add) == "add");
+    static_assert(opcode_values.at("jump") == opcode::jump);
+    static_assert(not opcode_values.contains("halt"));
+
+    // The pairs are sorted by key
+    static_assert(opcode_values.begin()->first == "add");
+    static_assert((opcode_values.end() - 1)->first == "store");
+}
+
+TEST(static_map, run_time) {
+    std::string_view parsed{"store r1"};
+
+    ASSERT_EQ(opcode_values.at(parsed.substr(0, 5)), opcode::store);
+    ASSERT_EQ(opcode_values.find("halt"), opcode_values.end());
+    ASSERT_THROW(static_cast<void>(opcode_values.at("halt")), const char*);
+
+    // Every size has to find every key and none of the keys in between
+    constexpr auto odd = mc::make_static_map<int, int>({{1, 10}, {3, 30}, {5, 50}, {7, 70}, {9, 90}});
+
+    for (int key = 0; key <= 10; key++) {
+        if (key % 2 == 1) {
+            ASSERT_EQ(odd.at(key), key * 10) << "static_map did not find a key!";
+        } else {
+            ASSERT_FALSE(odd.contains(key)) << "static_map found a key that is not there!";
+        }
+    }
+
+    constexpr auto single = mc::make_static_map<int, int>({{42, 1}});
+    ASSERT_TRUE(single.contains(42));
+    ASSERT_FALSE(single.contains(41));
+    ASSERT_FALSE(single.contains(43));
+}
@@ -3,7 +3,11 @@
 //
 
 #include <gtest/gtest.h>
+#include <cmath>
+#include <limits>
+#include <memory_resource>
 #include <random>
+#include "pair.h"
 #include "vector.h"
 
 TEST(vector, creation) {
@@ -110,4 +114,305 @@ TEST(vector, zalewski_idea) {
     // int_wrapper and int are different types, compare them by entry instead of by vector template
     for (std::size_t i = 0; i < vec.size(); i++)
         ASSERT_EQ(vec[i], compare[i]) << "int_wrapper vector is not the same as a normal int vector!";
-}
\ No newline at end of file
+}
+
+// Counts how many objects are alive, mc::vector should only construct the elements we push back
+struct counted {
+    static inline int alive = 0;
+    int value;
+
+    // No default constructor on purpose, new T[] would not compile with this type
+    explicit counted(int v): value{v} { alive++; }
+    counted(const counted& other): value{other.value} { alive++; }
+    counted& operator=(const counted&) = default;
+    ~counted() { alive--; }
+};
+
+TEST(vector, raw_storage) {
+    {
+        mc::vector<counted> vec{};
+        ASSERT_EQ(counted::alive, 0) << "Constructing an empty vector should not construct any elements!";
+
+        for (int i = 0; i < 100; i++) {
+            vec.push_back(counted{i});
+        }
+
+        ASSERT_EQ(counted::alive, 100) << "Growing the vector constructed or leaked elements!";
+
+        vec.erase(50);
+        vec.pop_back();
+        ASSERT_EQ(counted::alive, 98) << "erase(i) or pop_back() did not destroy the removed element!";
+
+        vec.insert(0, counted{-1});
+        ASSERT_EQ(vec[0].value, -1) << "Insert at the front does not insert properly!";
+        ASSERT_EQ(vec[1].value, 0) << "Insert at the front does not shift properly!";
+        ASSERT_EQ(counted::alive, 99);
+
+        mc::vector<counted> copy{vec};
+        ASSERT_EQ(counted::alive, 198);
+
+        vec.erase();
+        ASSERT_EQ(counted::alive, 99) << "erase() did not destroy all elements!";
+    }
+
+    ASSERT_EQ(counted::alive, 0) << "The destructor did not destroy all live elements!";
+}
+
+TEST(vector, emplace) {
+    // std::unique_ptr can only be moved, so this only compiles if nothing is copied
+    mc::vector<std::unique_ptr<int>> vec{};
+
+    for (int i = 0; i < 50; i++) {
+        vec.push_back(std::make_unique<int>(i));
+    }
+
+    auto& front = vec.emplace(0, new int{-1});
+    ASSERT_EQ(*front, -1) << "emplace does not return the new element!";
+    ASSERT_EQ(*vec[1], 0) << "emplace does not shift properly!";
+
+    auto& back = vec.emplace_back(new int{50});
+    ASSERT_EQ(*back, 50) << "emplace_back does not return the new element!";
+    ASSERT_EQ(vec.size(), 52);
+
+    // Pushing back a copy of our own element while growing must not read from the moved-out buffer
+    mc::vector<std::string> strings(1);
+    strings.push_back("a string that is too long for the small string optimisation");
+    strings.push_back(strings[0]);
+    ASSERT_EQ(strings[0], strings[1]) << "push_back of an own element breaks when the vector grows!";
+    ASSERT_EQ(strings.capacity(), 4);
+}
+
+TEST(vector, capacity) {
+    mc::vector<int> vec{};
+
+    vec.reserve(1000);
+    ASSERT_EQ(vec.capacity(), 1000) << "reserve() does not allocate the requested capacity!";
+
+    for (int i = 0; i < 1000; i++) {
+        vec.push_back(i);
+    }
+    ASSERT_EQ(vec.capacity(), 1000) << "push_back() reallocated after reserve()!";
+
+    vec.resize(10);
+    ASSERT_EQ(vec.size(), 10) << "resize() does not shrink the size!";
+    ASSERT_EQ(vec[9], 9);
+
+    vec.resize(12, 42);
+    ASSERT_EQ(vec[11], 42) << "resize() does not fill with the given value!";
+
+    vec.resize(13);
+    ASSERT_EQ(vec[12], 0) << "resize() does not value-initialise new elements!";
+
+    vec.shrink_to_fit();
+    ASSERT_EQ(vec.capacity(), 13) << "shrink_to_fit() does not release the unused capacity!";
+
+    vec.clear();
+    ASSERT_EQ(vec.size(), 0) << "clear() does not remove all elements!";
+    ASSERT_EQ(vec.capacity(), 13) << "clear() should keep the capacity!";
+}
+
+TEST(vector, max_size) {
+    mc::vector<mc::pair<uint64_t, uint64_t>> vec;
+    vec.push_back({1, 2});
+
+    // 2^60 pairs of 16 bytes would wrap around to 0 bytes, that has to throw and leave the vector as it was
+    ASSERT_THROW(vec.reserve(1ull << 60), const char*);
+    ASSERT_THROW(vec.reserve(vec.max_size() + 1), const char*);
+    ASSERT_THROW(vec.resize(std::numeric_limits<std::size_t>::max()), const char*);
+
+    ASSERT_EQ(vec.size(), 1);
+    ASSERT_EQ(vec[0].second, 2) << "a rejected reserve() changed the vector!";
+
+    // Growth stops at the largest capacity whose bytes still fit
+    constexpr std::size_t limit = std::numeric_limits<std::size_t>::max() / 16;
+    ASSERT_EQ(mc::growth::doubling::next_capacity(limit - 10, limit - 5, 16), limit);
+}
+
+TEST(vector, growth_policy) {
+    mc::vector<int, mc::growth::one_and_a_half> slow(4);
+
+    for (int i = 0; i < 5; i++) {
+        slow.push_back(i);
+    }
+    ASSERT_EQ(slow.capacity(), 6) << "1.5x growth policy does not grow by 1.5!";
+
+    // 1000 ints is just under a page, growing past that should round up to whole pages
+    mc::vector<int, mc::growth::page_granular<4096>> paged(1000);
+
+    for (int i = 0; i < 1001; i++) {
+        paged.push_back(i);
+    }
+    ASSERT_EQ(paged.capacity() * sizeof(int) % 4096, 0) << "page granular growth policy does not use whole pages!";
+}
+
+TEST(vector, trivially_relocatable) {
+    static_assert(mc::is_trivially_relocatable_v<int>);
+    static_assert(not mc::is_trivially_relocatable_v<std::string>);
+
+    // These go through realloc and memmove, compare against std::vector which does it element by element
+    mc::vector<uint64_t> vec(1);
+    std::vector<uint64_t> compare{};
+
+    std::mt19937 mtw;
+    mtw.seed((int)time(nullptr));
+
+    for (std::size_t i = 0; i < 2000; i++) {
+        uint64_t value = mtw();
+        std::size_t index = vec.size() == 0 ? 0 : mtw() % vec.size();
+
+        switch (mtw() % 3) {
+            case 0:
+                vec.push_back(value);
+                compare.push_back(value);
+                break;
+            case 1:
+                vec.insert(index, value);
+                compare.insert(compare.begin() + (std::ptrdiff_t)std::min(index, compare.size()), value);
+                break;
+            default:
+                if (not compare.empty()) {
+                    vec.erase(index);
+                    compare.erase(compare.begin() + (std::ptrdiff_t)index);
+                }
+        }
+    }
+
+    ASSERT_EQ(vec.size(), compare.size()) << "trivially relocatable vector has the wrong size!";
+    ASSERT_TRUE(std::equal(vec.begin(), vec.end(), compare.begin())) << "trivially relocatable vector has the wrong content!";
+
+    mc::vector<uint64_t> copy{vec};
+    ASSERT_EQ(copy, vec) << "memcpy copy constructor does not copy properly!";
+}
+
+// Forwards to the default resource and remembers how many bytes are still allocated
+struct counting_resource : std::pmr::memory_resource {
+    std::size_t in_use = 0;
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        in_use += bytes;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+        in_use -= bytes;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+TEST(vector, pmr) {
+    counting_resource resource;
+
+    {
+        mc::pmr::vector<std::pmr::string> vec{&resource};
+
+        for (int i = 0; i < 100; i++) {
+            vec.emplace_back("a string that is too long for the small string optimisation");
+        }
+
+        ASSERT_EQ(vec.get_allocator().resource(), &resource) << "pmr vector does not use its memory resource!";
+        ASSERT_EQ(vec[0].get_allocator().resource(), &resource) << "pmr vector does not pass its allocator to its elements!";
+        ASSERT_GE(resource.in_use, vec.capacity() * sizeof(std::pmr::string));
+
+        // A copy goes back to the default resource, assigning keeps the resource of the target
+        mc::pmr::vector<std::pmr::string> copy{vec};
+        ASSERT_EQ(copy.get_allocator().resource(), std::pmr::get_default_resource());
+
+        mc::pmr::vector<std::pmr::string> assigned{&resource};
+        assigned = copy;
+        ASSERT_EQ(assigned.get_allocator().resource(), &resource) << "operator= should not propagate a pmr allocator!";
+        ASSERT_EQ(assigned, copy);
+    }
+
+    ASSERT_EQ(resource.in_use, 0) << "pmr vector did not give back all of its memory!";
+}
+
+TEST(vector, move) {
+    mc::vector<std::string> vec{"a", "b", "c"};
+    const std::string* data = vec.raw();
+
+    mc::vector<std::string> moved{std::move(vec)};
+    ASSERT_EQ(moved.raw(), data) << "move constructor copied the buffer instead of taking it over!";
+    ASSERT_EQ(moved.size(), 3);
+    ASSERT_EQ(vec.size(), 0) << "move constructor did not leave the vector empty!";
+
+    // A moved-from vector can be used again
+    vec.push_back("d");
+    ASSERT_EQ(vec[0], "d");
+
+    vec = std::move(moved);
+    ASSERT_EQ(vec.raw(), data) << "move assignment copied the buffer instead of taking it over!";
+    ASSERT_EQ(vec[2], "c");
+
+    static_assert(std::is_nothrow_move_constructible_v<mc::vector<std::string>>);
+    static_assert(std::is_nothrow_move_assignable_v<mc::vector<std::string>>);
+}
+
+template <typename T>
+void check_simd_kernels() {
+    // Every length up to a couple of registers, so both the vector loop and the scalar tail are covered
+    for (std::size_t length = 0; length < 100; length++) {
+        mc::vector<T> vec(length);
+        std::vector<T> compare;
+
+        for (std::size_t i = 0; i < length; i++) {
+            auto value = static_cast<T>((i * 37) % 23);
+            vec.push_back(value);
+            compare.push_back(value);
+        }
+
+        mc::vector<T> copy{vec};
+        ASSERT_EQ(copy, vec) << "SIMD operator== does not find equal vectors equal!";
+
+        if (length != 0) {
+            copy[length - 1] = static_cast<T>(100);
+            ASSERT_FALSE(copy == vec) << "SIMD operator== misses a difference in the last element!";
+        }
+
+        for (int needle = 0; needle < 24; needle++) {
+            auto value = static_cast<T>(needle);
+            ASSERT_EQ(vec.find(value) - vec.begin(), std::find(compare.begin(), compare.end(), value) - compare.begin()) << "SIMD find failed!";
+            ASSERT_EQ(vec.count(value), (std::size_t)std::count(compare.begin(), compare.end(), value)) << "SIMD count failed!";
+        }
+
+        ASSERT_EQ(vec.min_element() - vec.begin(), std::min_element(compare.begin(), compare.end()) - compare.begin()) << "SIMD min failed!";
+        ASSERT_EQ(vec.max_element() - vec.begin(), std::max_element(compare.begin(), compare.end()) - compare.begin()) << "SIMD max failed!";
+    }
+}
+
+TEST(vector, simd) {
+    check_simd_kernels<int8_t>();
+    check_simd_kernels<uint16_t>();
+    check_simd_kernels<int32_t>();
+    check_simd_kernels<uint64_t>();
+    check_simd_kernels<float>();
+    check_simd_kernels<double>();
+
+    // Other types use the scalar loops
+    mc::vector<std::string> strings{"b", "a", "c", "a"};
+    ASSERT_EQ(strings.find("a") - strings.begin(), 1);
+    ASSERT_EQ(strings.count("a"), 2);
+    ASSERT_EQ(*strings.max_element(), "c");
+
+    // Floating point equality is not the same as equal bits
+    mc::vector<double> zeros{0.0, 0.0, 0.0, 0.0, 0.0};
+    mc::vector<double> negative_zeros{-0.0, -0.0, -0.0, -0.0, -0.0};
+    ASSERT_EQ(zeros, negative_zeros) << "SIMD operator== should find 0.0 and -0.0 equal!";
+
+    mc::vector<double> nans{NAN, NAN, NAN, NAN, NAN};
+    ASSERT_FALSE(nans == nans) << "SIMD operator== should not find NaN equal to itself!";
+
+#if MC_SIMD_X86
+    // The checks above only use the SSE2 kernels on CPUs without AVX2, so test those directly as well
+    uint64_t numbers[37];
+    std::iota(numbers, numbers + 37, 0);
+    numbers[30] = 5;
+
+    ASSERT_TRUE(mc::simd::sse2::equal(numbers, numbers, 37));
+    ASSERT_EQ(mc::simd::sse2::find(numbers, 37, uint64_t{31}), 31) << "SSE2 find failed!";
+    ASSERT_EQ(mc::simd::sse2::count(numbers, 37, uint64_t{5}), 2) << "SSE2 count failed!";
+#endif
+}